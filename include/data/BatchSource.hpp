@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include "../utils/Matrix.hpp"
+#include "../utils/MatrixView.hpp"
+
+namespace ml {
+namespace data {
+
+/**
+ * @brief A block of consecutive rows: features plus their targets
+ */
+struct Batch {
+    utils::Matrix features;
+    std::vector<double> targets;
+
+    size_t rows() const { return targets.size(); }
+};
+
+/**
+ * @brief Sequential producer of fixed-size row batches
+ *
+ * Models that can learn incrementally consume a BatchSource instead of a
+ * fully materialized matrix, so only one batch has to be resident at a
+ * time. Every batch except possibly the last has batchSize() rows.
+ */
+class BatchSource {
+public:
+    virtual ~BatchSource() = default;
+
+    /**
+     * @brief Fill the next batch, reusing its storage when the shape allows
+     * @param batch Output batch
+     * @return False once the source is exhausted (batch is then left empty)
+     */
+    virtual bool next(Batch& batch) = 0;
+
+    /**
+     * @brief Rewind to the first batch (start of a new epoch)
+     */
+    virtual void reset() = 0;
+
+    /**
+     * @brief Number of feature columns in every batch
+     */
+    virtual size_t cols() const = 0;
+
+    /**
+     * @brief Rows per full batch
+     */
+    virtual size_t batchSize() const = 0;
+
+protected:
+    BatchSource() = default;
+};
+
+/**
+ * @brief BatchSource over an in-memory view, for data that already fits in RAM
+ */
+class ViewBatchSource : public BatchSource {
+public:
+    /**
+     * @brief Batch the rows of a view; the viewed features must outlive the source
+     * @param features Feature view
+     * @param targets Targets, one per row (copied, so a temporary is fine)
+     * @param batchSize Rows per batch
+     */
+    ViewBatchSource(const utils::MatrixView& features,
+                    const std::vector<double>& targets,
+                    size_t batchSize);
+
+    bool next(Batch& batch) override;
+    void reset() override { position_ = 0; }
+    size_t cols() const override { return features_.cols(); }
+    size_t batchSize() const override { return batchSize_; }
+
+private:
+    utils::MatrixView features_;
+    std::vector<double> targets_;
+    size_t batchSize_;
+    size_t position_ = 0;
+};
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
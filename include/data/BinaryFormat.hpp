@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ml {
+namespace data {
+
+/**
+ * @brief On-disk layout of the binary dataset format (version 1)
+ *
+ * All integers are native-endian; byteOrder lets a reader reject a file
+ * written on a machine of the other endianness.
+ *
+ *   [BinaryHeader]           64 bytes at offset 0
+ *   [feature names]          cols entries of (uint32 length, bytes)
+ *   [features]               rows x cols row-major, float64 or float32,
+ *                            starting on a 64-byte boundary
+ *   [targets]                rows float64, starting on a 64-byte boundary
+ *
+ * The feature block is row-major so a mapped file can be handed to the
+ * models as a MatrixView without any transposition or copy.
+ */
+namespace binary {
+
+constexpr char kMagic[8] = {'M', 'L', 'D', 'A', 'T', 'A', '\0', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr size_t kBlockAlignment = 64;
+
+enum class ElementType : uint32_t {
+    Float64 = 0,
+    Float32 = 1
+};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t elementType;   ///< ElementType of the feature block
+    uint32_t reserved;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t namesOffset;
+    uint64_t featuresOffset;
+    uint64_t targetsOffset;
+};
+
+static_assert(sizeof(Header) <= kBlockAlignment, "Header must fit in the first block");
+
+/**
+ * @brief Round an offset up to the next block boundary
+ */
+inline uint64_t alignOffset(uint64_t offset) {
+    return (offset + kBlockAlignment - 1) / kBlockAlignment * kBlockAlignment;
+}
+
+} // namespace binary
+} // namespace data
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "BatchSource.hpp"
+
+namespace ml {
+namespace data {
+
+/**
+ * @brief Streams a CSV file as fixed-size batches with bounded memory
+ *
+ * Only the current line and the caller's batch are held in memory, so
+ * files larger than RAM can be consumed. Parsing follows
+ * DataLoader::loadFromCSV: blanks are trimmed, empty fields are skipped
+ * and the last field of each row is the target.
+ */
+class CSVBatchReader : public BatchSource {
+public:
+    /**
+     * @brief Open a CSV file for streaming
+     * @param filepath Path to the CSV file
+     * @param batchSize Rows per batch
+     * @param hasHeader Whether the CSV has a header row
+     * @param delimiter CSV delimiter character
+     * @throws std::runtime_error if the file cannot be opened
+     */
+    CSVBatchReader(const std::string& filepath,
+                   size_t batchSize,
+                   bool hasHeader = true,
+                   char delimiter = ',');
+
+    bool next(Batch& batch) override;
+    void reset() override;
+    size_t cols() const override { return cols_; }
+    size_t batchSize() const override { return batchSize_; }
+
+    /**
+     * @brief Column names from the header (target column excluded)
+     */
+    const std::vector<std::string>& getFeatureNames() const { return featureNames_; }
+
+    /**
+     * @brief Data rows produced since the last reset()
+     */
+    size_t rowsRead() const { return rowsRead_; }
+
+private:
+    std::string filepath_;
+    std::ifstream file_;
+    size_t batchSize_;
+    bool hasHeader_;
+    char delimiter_;
+    size_t cols_ = 0;
+    size_t rowsRead_ = 0;
+    std::vector<std::string> featureNames_;
+    std::string line_;
+    bool pendingLine_ = false;  // line_ holds a data row read while sizing the columns
+
+    /**
+     * @brief Rewind the stream and skip the header
+     */
+    void rewind();
+
+    /**
+     * @brief Read the next line with at least one field into line_
+     */
+    bool readDataLine();
+};
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace ml {
+namespace data {
+
+/**
+ * @brief Allocation-free helpers shared by the CSV readers
+ *
+ * Lines and fields are handled as [begin, end) character ranges into the
+ * caller's buffer. Fields are split on the delimiter, trimmed of blanks, and
+ * empty fields are skipped; numbers are parsed with std::from_chars.
+ */
+namespace csv {
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/**
+ * @brief Call fn(lineBegin, lineEnd) for every line of [begin, end)
+ */
+template <typename Fn>
+void forEachLine(const char* begin, const char* end, Fn&& fn) {
+    while (begin < end) {
+        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        const char* lineEnd = newline ? newline : end;
+        fn(begin, lineEnd);
+        begin = newline ? newline + 1 : end;
+    }
+}
+
+/**
+ * @brief Call fn(fieldBegin, fieldEnd) for every trimmed, non-empty field of a line
+ */
+template <typename Fn>
+void forEachField(const char* line, const char* lineEnd, char delimiter, Fn&& fn) {
+    const char* fieldBegin = line;
+    while (true) {
+        const char* fieldEnd = static_cast<const char*>(
+            std::memchr(fieldBegin, delimiter, lineEnd - fieldBegin));
+        if (!fieldEnd) {
+            fieldEnd = lineEnd;
+        }
+
+        const char* first = fieldBegin;
+        const char* last = fieldEnd;
+        while (first < last && isBlank(*first)) ++first;
+        while (last > first && isBlank(last[-1])) --last;
+        if (first < last) {
+            fn(first, last);
+        }
+
+        if (fieldEnd == lineEnd) {
+            break;
+        }
+        fieldBegin = fieldEnd + 1;
+    }
+}
+
+inline size_t countFields(const char* line, const char* lineEnd, char delimiter) {
+    size_t count = 0;
+    forEachField(line, lineEnd, delimiter, [&](const char*, const char*) { ++count; });
+    return count;
+}
+
+[[noreturn]] inline void throwParseError(const char* line, const char* lineEnd, const std::string& reason) {
+    throw std::runtime_error("Error parsing line: " + std::string(line, lineEnd) + "\nError: " + reason);
+}
+
+template <typename T>
+T parseNumber(const char* first, const char* last, const char* line, const char* lineEnd) {
+    // from_chars rejects the leading '+' that stod used to accept
+    if (*first == '+' && last - first > 1) {
+        ++first;
+    }
+    T value{};
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc() || ptr != last) {
+        throwParseError(line, lineEnd, "invalid number '" + std::string(first, last) + "'");
+    }
+    return value;
+}
+
+} // namespace csv
+} // namespace data
+} // namespace ml
\ No newline at end of file
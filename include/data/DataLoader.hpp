@@ -4,10 +4,38 @@
 #include <vector>
 #include <memory>
 #include "../utils/Matrix.hpp"
+#include "../utils/MatrixView.hpp"
+#include "../utils/MappedFile.hpp"
+#include "CSVBatchReader.hpp"
 
 namespace ml {
 namespace data {
 
+/**
+ * @brief Storage precision for loaded feature matrices
+ */
+enum class Precision {
+    Float64,
+    Float32
+};
+
+/**
+ * @brief Timing and size of the most recent load
+ */
+struct LoadStats {
+    size_t bytes = 0;     ///< Bytes of input scanned
+    size_t rows = 0;      ///< Data rows parsed
+    size_t chunks = 0;    ///< Newline-aligned chunks parsed in parallel
+    double seconds = 0.0; ///< Wall time from open to filled matrix
+
+    /**
+     * @brief Parse throughput in MB/s (0 when nothing was timed)
+     */
+    double megabytesPerSecond() const {
+        return seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+    }
+};
+
 class DataLoader {
 public:
     DataLoader() = default;
@@ -19,20 +47,115 @@ public:
 
     /**
      * @brief Load data from a CSV file
+     *
+     * The file is memory-mapped and split into newline-aligned chunks that
+     * are parsed in parallel with std::from_chars straight into the final
+     * feature matrix. Fields are trimmed of blanks and empty fields are
+     * skipped; the last field of every row is the target.
+     *
      * @param filepath Path to the CSV file
      * @param hasHeader Whether the CSV has a header row
      * @param delimiter CSV delimiter character
+     * @param precision Storage precision of the feature matrix; Float32 fills
+     *        getFeaturesF() and leaves getFeatures() empty
      * @return True if loading was successful
      */
     bool loadFromCSV(const std::string& filepath, 
                     bool hasHeader = true, 
-                    char delimiter = ',');
+                    char delimiter = ',',
+                    Precision precision = Precision::Float64);
+
+    /**
+     * @brief Open a CSV file for batch-wise streaming instead of loading it
+     *
+     * For files too large to materialize; memory stays bounded by one batch.
+     *
+     * @param filepath Path to the CSV file
+     * @param batchSize Rows per batch
+     * @param hasHeader Whether the CSV has a header row
+     * @param delimiter CSV delimiter character
+     * @return Reader positioned at the first batch
+     */
+    static CSVBatchReader streamCSV(const std::string& filepath,
+                                    size_t batchSize,
+                                    bool hasHeader = true,
+                                    char delimiter = ',');
+
+    /**
+     * @brief Memory-map a dataset written by saveBinary() or convertCSVToBinary()
+     *
+     * Nothing is parsed: the feature block is used in place and its pages
+     * are read lazily on first touch. Targets and names are copied out.
+     *
+     * @param filepath Path to the binary file
+     * @return True if the file holds at least one row
+     * @throws std::runtime_error if the file is not a valid binary dataset
+     */
+    bool loadFromBinary(const std::string& filepath);
+
+    /**
+     * @brief Write the loaded data in the binary dataset format
+     * @param filepath Output path
+     */
+    void saveBinary(const std::string& filepath) const;
+
+    /**
+     * @brief Convert a CSV file to the binary dataset format
+     *
+     * Streams the CSV in batches, so memory is bounded by one batch plus
+     * the targets.
+     *
+     * @param csvPath Input CSV path
+     * @param binaryPath Output path
+     * @param hasHeader Whether the CSV has a header row
+     * @param delimiter CSV delimiter character
+     * @param precision Element type of the stored feature block
+     * @return Number of rows written
+     */
+    static size_t convertCSVToBinary(const std::string& csvPath,
+                                     const std::string& binaryPath,
+                                     bool hasHeader = true,
+                                     char delimiter = ',',
+                                     Precision precision = Precision::Float64);
 
     /**
      * @brief Get the loaded feature matrix
+     *
+     * After loadFromBinary() the matrix is copied out of the mapping on
+     * first call; prefer getFeaturesView() to stay zero-copy.
+     *
      * @return Const reference to the feature matrix
      */
-    const utils::Matrix& getFeatures() const { return features_; }
+    const utils::Matrix& getFeatures() const;
+
+    /**
+     * @brief Get the loaded single-precision feature matrix
+     * @return Const reference to the feature matrix (empty unless loaded as Float32)
+     */
+    const utils::MatrixF& getFeaturesF() const;
+
+    /**
+     * @brief Zero-copy view of the double-precision features
+     * @return View valid until the next load or the loader's destruction
+     */
+    utils::MatrixView getFeaturesView() const;
+
+    /**
+     * @brief Zero-copy view of the single-precision features
+     * @return View valid until the next load or the loader's destruction
+     */
+    utils::MatrixViewF getFeaturesViewF() const;
+
+    /**
+     * @brief Get the precision the features were loaded with
+     * @return Storage precision of the last load
+     */
+    Precision precision() const { return precision_; }
+
+    /**
+     * @brief Size and throughput of the last successful load
+     */
+    const LoadStats& lastLoadStats() const { return stats_; }
 
     /**
      * @brief Get the loaded target vector
@@ -47,7 +170,14 @@ public:
     const std::vector<std::string>& getFeatureNames() const { return featureNames_; }
 
 private:
-    utils::Matrix features_;
+    // Materialized lazily from the mapping after a binary load
+    mutable utils::Matrix features_;
+    mutable utils::MatrixF featuresF_;
+    utils::MappedFile mapped_;
+    utils::MatrixView mappedFeatures_;
+    utils::MatrixViewF mappedFeaturesF_;
+    Precision precision_ = Precision::Float64;
+    LoadStats stats_;
     std::vector<double> targets_;
     std::vector<std::string> featureNames_;
     
@@ -58,6 +188,11 @@ private:
      * @return Vector of tokens
      */
     std::vector<std::string> parseLine(const std::string& line, char delimiter) const;
+
+    /**
+     * @brief Drop any mapped binary dataset
+     */
+    void unmap();
 };
 
 } // namespace data
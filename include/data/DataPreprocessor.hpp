@@ -1,8 +1,11 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <vector>
 #include "../utils/Matrix.hpp"
+#include "../utils/MatrixView.hpp"
 
 namespace ml {
 namespace data {
@@ -15,35 +18,59 @@ public:
      * @param targets Input target vector
      * @param trainRatio Ratio of training data (0.0 - 1.0)
      * @param shuffle Whether to shuffle the data before splitting
-     * @return Pair of training and testing data
+     * @param seed Seed for the shuffle; unset draws one from std::random_device
+     * @return Pair of training and testing data; the feature halves are
+     *         row-index views into `features`, which must outlive them
+     */
+    static std::pair<std::pair<utils::MatrixView, std::vector<double>>,
+                    std::pair<utils::MatrixView, std::vector<double>>>
+    trainTestSplit(const utils::MatrixView& features,
+                  const std::vector<double>& targets,
+                  double trainRatio = 0.8,
+                  bool shuffle = true,
+                  std::optional<uint64_t> seed = std::nullopt);
+
+    /**
+     * @brief Single-precision overload of trainTestSplit
      */
-    static std::pair<std::pair<utils::Matrix, std::vector<double>>,
-                    std::pair<utils::Matrix, std::vector<double>>>
-    trainTestSplit(const utils::Matrix& features,
+    static std::pair<std::pair<utils::MatrixViewF, std::vector<double>>,
+                    std::pair<utils::MatrixViewF, std::vector<double>>>
+    trainTestSplit(const utils::MatrixViewF& features,
                   const std::vector<double>& targets,
                   double trainRatio = 0.8,
-                  bool shuffle = true);
+                  bool shuffle = true,
+                  std::optional<uint64_t> seed = std::nullopt);
 
     /**
      * @brief Standardize features (zero mean, unit variance)
+     *
+     * Fits and applies a StandardScaler in one call; use the scaler directly
+     * to reuse the fitted statistics on test or serving data.
+     *
      * @param features Input feature matrix
      * @return Standardized features
      */
-    static utils::Matrix standardize(const utils::Matrix& features);
+    static utils::Matrix standardize(const utils::MatrixView& features);
+    static utils::MatrixF standardize(const utils::MatrixViewF& features);
 
     /**
      * @brief Normalize features to [0, 1] range
+     *
+     * Fits and applies a MinMaxScaler in one call.
+     *
      * @param features Input feature matrix
      * @return Normalized features
      */
-    static utils::Matrix normalize(const utils::Matrix& features);
+    static utils::Matrix normalize(const utils::MatrixView& features);
+    static utils::MatrixF normalize(const utils::MatrixViewF& features);
 
     /**
      * @brief Add bias term (column of ones) to features
      * @param features Input feature matrix
      * @return Features with bias term
      */
-    static utils::Matrix addBias(const utils::Matrix& features);
+    static utils::Matrix addBias(const utils::MatrixView& features);
+    static utils::MatrixF addBias(const utils::MatrixViewF& features);
 
 private:
     DataPreprocessor() = delete;  // Static class
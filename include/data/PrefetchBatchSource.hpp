@@ -0,0 +1,116 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "BatchSource.hpp"
+
+namespace ml {
+namespace data {
+
+/**
+ * @brief Queue depth, shuffling and transform of a PrefetchBatchSource
+ */
+struct PrefetchOptions {
+    size_t depth = 2;                        ///< Ready batches buffered ahead of the consumer
+    bool shuffle = false;                    ///< Mix rows across batches through a shuffle buffer
+    size_t shuffleRows = 0;                  ///< Shuffle buffer rows; 0 means 4 * depth * batchSize
+    uint64_t seed = 0;                       ///< Seed for the row shuffle
+    /**
+     * Applied to every batch on the producer thread. To standardize a
+     * stream, fit a StandardScaler on the training set (partialFit over
+     * the batches works) and call its transformInPlace on batch.features;
+     * per-batch statistics would differ from batch to batch.
+     */
+    std::function<void(Batch&)> transform;
+};
+
+/**
+ * @brief PrefetchBatchSource counters: show whether training is I/O- or compute-bound
+ */
+struct PrefetchStats {
+    size_t batches = 0;              ///< Batches delivered by next()
+    double consumerWaitSeconds = 0;  ///< Time next() spent waiting for data
+    double producerWaitSeconds = 0;  ///< Time the producer spent blocked on a full queue
+};
+
+/**
+ * @brief Runs another BatchSource on a background thread, a few batches ahead
+ *
+ * The producer thread reads the next batch from the upstream source,
+ * optionally shuffles rows and applies a transform (e.g. standardization)
+ * while the model trains on the current one. Ready batches wait in a queue
+ * bounded by PrefetchOptions::depth; when it is full the producer blocks,
+ * so memory stays at depth + 2 batches (the queue, the one the producer is
+ * filling and the consumer's), plus the shuffle buffer when shuffling.
+ * Buffers are recycled: the batch handed back by next() becomes the
+ * producer's next output buffer.
+ *
+ * Shuffling keeps up to shuffleRows upstream rows in a buffer and fills
+ * each batch with rows drawn from it at random, topping it up as it
+ * drains. A row can therefore move anywhere within a window of about
+ * shuffleRows rows, across batch boundaries; a shuffle of the whole
+ * stream needs a buffer as large as the stream.
+ *
+ * Exceptions thrown upstream or by the transform are rethrown from next().
+ */
+class PrefetchBatchSource : public BatchSource {
+public:
+    /**
+     * @brief Start prefetching from the upstream source's current position
+     * @param upstream Source to read from; must outlive this object and not be used directly meanwhile
+     * @param options Queue depth, shuffling and transform
+     */
+    explicit PrefetchBatchSource(BatchSource& upstream, PrefetchOptions options = PrefetchOptions());
+    ~PrefetchBatchSource() override;
+
+    PrefetchBatchSource(const PrefetchBatchSource&) = delete;
+    PrefetchBatchSource& operator=(const PrefetchBatchSource&) = delete;
+
+    bool next(Batch& batch) override;
+    void reset() override;
+    size_t cols() const override { return upstream_.cols(); }
+    size_t batchSize() const override { return upstream_.batchSize(); }
+
+    /**
+     * @brief Snapshot of the pipeline counters
+     */
+    PrefetchStats stats() const;
+
+private:
+    BatchSource& upstream_;
+    PrefetchOptions options_;
+    std::mt19937_64 rng_;
+
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Batch> ready_;
+    std::vector<Batch> free_;
+    bool finished_ = false;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    PrefetchStats stats_;
+
+    // Shuffle buffer, producer thread only: rows [0, poolRows_) of pool_
+    // are waiting to be drawn
+    utils::Matrix pool_;
+    std::vector<double> poolTargets_;
+    size_t poolRows_ = 0;
+    bool upstreamDone_ = false;
+    Batch incoming_;
+
+    void start();
+    void stop();
+    void produce();
+    bool nextShuffled(Batch& batch);
+};
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <vector>
+#include "../utils/Matrix.hpp"
+#include "../utils/MatrixView.hpp"
+#include "BatchSource.hpp"
+
+namespace ml {
+namespace data {
+
+/**
+ * @brief Mergeable per-column count, mean, variance, min and max
+ *
+ * Rows are folded in with Welford's update, which walks each row
+ * contiguously and is numerically stable in one pass. Accumulators over
+ * disjoint row sets combine exactly with merge() (Chan et al.), which is how
+ * large inputs are split across threads and how batches of a stream are
+ * combined.
+ */
+class ColumnStatistics {
+public:
+    explicit ColumnStatistics(size_t cols = 0);
+
+    /**
+     * @brief Fold in every row of a view
+     *
+     * Large views are split into fixed-size row blocks accumulated in
+     * parallel and merged in order, so the result does not depend on the
+     * thread count.
+     */
+    void add(const utils::MatrixView& rows);
+    void add(const utils::MatrixViewF& rows);
+
+    /**
+     * @brief Combine with statistics gathered over other rows
+     */
+    void merge(const ColumnStatistics& other);
+
+    size_t cols() const { return mean_.size(); }
+    size_t count() const { return count_; }
+    const std::vector<double>& mean() const { return mean_; }
+    const std::vector<double>& min() const { return min_; }
+    const std::vector<double>& max() const { return max_; }
+
+    /**
+     * @brief Population variance (divides by count)
+     */
+    std::vector<double> variance() const;
+
+private:
+    size_t count_;
+    std::vector<double> mean_;
+    std::vector<double> m2_;
+    std::vector<double> min_;
+    std::vector<double> max_;
+
+    template <typename T>
+    void addRows(const utils::BasicMatrixView<T>& rows, size_t begin, size_t end);
+
+    template <typename T>
+    void addParallel(const utils::BasicMatrixView<T>& rows);
+};
+
+/**
+ * @brief Common interface of fitted column-wise affine transforms
+ *
+ * A scaler stores one offset and one scale per column and maps
+ * x -> (x - offset) / scale. Fit it on training data only, then apply the
+ * same transform to validation, test and serving data.
+ */
+class Scaler {
+public:
+    virtual ~Scaler() = default;
+
+    /**
+     * @brief Fit on a matrix, replacing any previous fit
+     * @return Reference to this scaler
+     */
+    Scaler& fit(const utils::MatrixView& features);
+    Scaler& fit(const utils::MatrixViewF& features);
+
+    /**
+     * @brief Fit on every batch of a stream in one pass
+     * @param source Batch source; rewound before use
+     * @return Reference to this scaler
+     */
+    Scaler& fit(BatchSource& source);
+
+    /**
+     * @brief Fold more rows into the fit, for data arriving in batches
+     */
+    void partialFit(const utils::MatrixView& features);
+    void partialFit(const utils::MatrixViewF& features);
+
+    /**
+     * @brief Apply the fitted transform to a copy
+     */
+    utils::Matrix transform(const utils::MatrixView& features) const;
+    utils::MatrixF transform(const utils::MatrixViewF& features) const;
+
+    /**
+     * @brief Apply the fitted transform in place
+     */
+    void transformInPlace(utils::Matrix& features) const;
+    void transformInPlace(utils::MatrixF& features) const;
+
+    /**
+     * @brief Undo the transform in place
+     */
+    void inverseTransformInPlace(utils::Matrix& features) const;
+
+    utils::Matrix fitTransform(const utils::MatrixView& features);
+    utils::MatrixF fitTransform(const utils::MatrixViewF& features);
+
+    bool isFitted() const { return statistics_.count() > 0; }
+
+    /**
+     * @brief Statistics the transform was derived from
+     */
+    const ColumnStatistics& statistics() const { return statistics_; }
+
+    /**
+     * @brief Per-column value subtracted by the transform
+     */
+    const std::vector<double>& offset() const { return offset_; }
+
+    /**
+     * @brief Per-column divisor applied after the offset (never zero)
+     */
+    const std::vector<double>& scale() const { return scale_; }
+
+protected:
+    Scaler() = default;
+
+    /**
+     * @brief Derive offset_ and scale_ from statistics_
+     */
+    virtual void updateTransform() = 0;
+
+    ColumnStatistics statistics_;
+    std::vector<double> offset_;
+    std::vector<double> scale_;
+
+private:
+    template <typename T>
+    void apply(utils::BasicMatrix<T>& features) const;
+
+    void checkColumns(size_t cols) const;
+};
+
+/**
+ * @brief Zero mean, unit variance per column
+ *
+ * Constant columns are centred but not scaled.
+ */
+class StandardScaler : public Scaler {
+protected:
+    void updateTransform() override;
+};
+
+/**
+ * @brief Map each column's fitted [min, max] onto [0, 1]
+ *
+ * Constant columns map to 0. Values outside the fitted range fall outside
+ * [0, 1].
+ */
+class MinMaxScaler : public Scaler {
+protected:
+    void updateTransform() override;
+};
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Model.hpp"
+
+namespace ml {
+namespace models {
+
+/**
+ * @brief One train/test split, as row indices into the shared dataset
+ */
+struct Fold {
+    size_t repeat = 0;               ///< Repetition this fold belongs to
+    size_t index = 0;                ///< Position of the fold within its repetition
+    std::vector<size_t> train;       ///< Training rows, ascending
+    std::vector<size_t> test;        ///< Held-out rows, ascending
+};
+
+/**
+ * @brief Score function comparing actual and predicted targets (e.g. Metrics::accuracy)
+ */
+struct NamedMetric {
+    std::string name;
+    std::function<double(const std::vector<double>&, const std::vector<double>&)> score;
+};
+
+/**
+ * @brief Scores and timings of one evaluated fold
+ */
+struct FoldResult {
+    size_t repeat = 0;
+    size_t index = 0;
+    bool trained = false;            ///< Whether train() reported success; scores are empty otherwise
+    std::vector<double> scores;      ///< One entry per metric, in the order given
+    double trainSeconds = 0;
+    double predictSeconds = 0;
+};
+
+/**
+ * @brief Per-fold results of a cross-validation run
+ */
+struct CrossValidationResult {
+    std::vector<std::string> metricNames;
+    std::vector<FoldResult> folds;   ///< In the order of the input folds
+
+    /**
+     * @brief Mean of a metric over the successfully trained folds
+     * @param metric Index into metricNames
+     */
+    double mean(size_t metric) const;
+
+    /**
+     * @brief Sample standard deviation of a metric over the successfully trained folds
+     * @param metric Index into metricNames
+     */
+    double stdDev(size_t metric) const;
+};
+
+/**
+ * @brief Split generation and parallel evaluation for k-fold cross-validation
+ *
+ * Folds are index arrays over one dataset: every fold's training and test
+ * sets are row-index views (MatrixView::selectRows) of the caller's feature
+ * matrix, so no fold copies the features. Splits are a pure function of
+ * the seed, and evaluation runs folds concurrently on the shared
+ * ThreadPool with each fold's own training kept on its thread.
+ */
+class CrossValidation {
+public:
+    using ModelFactory = std::function<std::unique_ptr<Model>()>;
+
+    /**
+     * @brief Partition the rows into k folds of near-equal size
+     * @param samples Number of rows
+     * @param k Number of folds (2 <= k <= samples)
+     * @param shuffle Whether to shuffle rows before partitioning
+     * @param seed Seed for the shuffle
+     * @return k folds; each row is in exactly one test set
+     */
+    static std::vector<Fold> kFold(size_t samples, size_t k,
+                                   bool shuffle = true, uint64_t seed = 0);
+
+    /**
+     * @brief k folds that each preserve the class proportions of the targets
+     *
+     * Rows are grouped by target value, shuffled within each class and dealt
+     * to the folds in turn, so every class is spread as evenly as possible.
+     *
+     * @param targets Class labels
+     * @param k Number of folds (2 <= k <= number of rows)
+     * @param shuffle Whether to shuffle rows within each class
+     * @param seed Seed for the shuffle
+     */
+    static std::vector<Fold> stratifiedKFold(const std::vector<double>& targets, size_t k,
+                                             bool shuffle = true, uint64_t seed = 0);
+
+    /**
+     * @brief kFold repeated with a different shuffle each time
+     * @param repeats Number of repetitions; folds are numbered by Fold::repeat
+     */
+    static std::vector<Fold> repeatedKFold(size_t samples, size_t k, size_t repeats,
+                                           uint64_t seed = 0);
+
+    /**
+     * @brief stratifiedKFold repeated with a different shuffle each time
+     */
+    static std::vector<Fold> repeatedStratifiedKFold(const std::vector<double>& targets,
+                                                     size_t k, size_t repeats,
+                                                     uint64_t seed = 0);
+
+    /**
+     * @brief Train a fresh model on each fold and score it on the held-out rows
+     *
+     * Folds run in parallel; the factory is called once per fold, possibly
+     * from several threads at once. Exceptions from the factory or the model
+     * propagate to the caller.
+     *
+     * @param factory Creates an untrained model
+     * @param features Shared feature matrix; must outlive the call
+     * @param targets Targets, one per row
+     * @param folds Splits over the rows of features
+     * @param metrics Scores to compute on each fold's predictions
+     * @return Scores and timings per fold
+     */
+    static CrossValidationResult evaluate(const ModelFactory& factory,
+                                          const utils::MatrixView& features,
+                                          const std::vector<double>& targets,
+                                          const std::vector<Fold>& folds,
+                                          const std::vector<NamedMetric>& metrics);
+
+    /**
+     * @brief Single-precision overload of evaluate
+     */
+    static CrossValidationResult evaluate(const ModelFactory& factory,
+                                          const utils::MatrixViewF& features,
+                                          const std::vector<double>& targets,
+                                          const std::vector<Fold>& folds,
+                                          const std::vector<NamedMetric>& metrics);
+
+private:
+    CrossValidation() = delete;  // Static class
+};
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
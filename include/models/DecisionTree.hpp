@@ -25,10 +25,17 @@ public:
                          size_t maxFeatures = 0);
     ~DecisionTree() override = default;
 
-    bool train(const utils::Matrix& features,
+    using Model::train;
+    using Model::predict;
+
+    bool train(const utils::MatrixView& features,
+              const std::vector<double>& targets) override;
+
+    bool train(const utils::MatrixViewF& features,
               const std::vector<double>& targets) override;
 
-    std::vector<double> predict(const utils::Matrix& features) const override;
+    std::vector<double> predict(const utils::MatrixView& features) const override;
+    std::vector<double> predict(const utils::MatrixViewF& features) const override;
     std::vector<double> getParameters() const override;
 
 private:
@@ -37,13 +44,28 @@ private:
     size_t minSamplesSplit_;
     size_t maxFeatures_;
 
-    std::unique_ptr<DecisionTreeNode> buildTree(const utils::Matrix& features,
+    template <typename T>
+    bool fit(const utils::BasicMatrixView<T>& features,
+             const std::vector<double>& targets);
+
+    template <typename T>
+    std::vector<double> predictRows(const utils::BasicMatrixView<T>& features) const;
+
+    // Nodes are built over index ranges into the original training data;
+    // child partitions reorder `indices` in place rather than copying rows.
+    template <typename T>
+    std::unique_ptr<DecisionTreeNode> buildTree(const utils::BasicMatrixView<T>& features,
                                               const std::vector<double>& targets,
+                                              std::vector<size_t>& indices,
+                                              size_t begin, size_t end,
                                               size_t depth);
 
     static double calculateGini(const std::vector<double>& targets);
-    static std::pair<double, double> findBestSplit(const utils::Matrix& features,
+    template <typename T>
+    static std::pair<double, double> findBestSplit(const utils::BasicMatrixView<T>& features,
                                                   const std::vector<double>& targets,
+                                                  const std::vector<size_t>& indices,
+                                                  size_t begin, size_t end,
                                                   size_t featureIndex);
 };
 
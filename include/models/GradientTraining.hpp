@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Optimizer.hpp"
+#include "../utils/FunctionRef.hpp"
+
+namespace ml {
+namespace models {
+
+/**
+ * @brief Outcome of runMiniBatches()
+ */
+struct MiniBatchRun {
+    size_t epochs = 0;          ///< Epochs completed
+    double loss = 0.0;          ///< Mean loss of the last epoch, summed over its batches
+    bool converged = false;     ///< The last epoch's loss fell below the tolerance
+};
+
+/**
+ * @brief Reject mini-batch settings no model can train with
+ * @throws std::invalid_argument if options.epochs is 0
+ */
+void validateMiniBatchOptions(const MiniBatchOptions& options);
+
+/**
+ * @brief Largest absolute entry of a gradient
+ */
+double maxAbs(const std::vector<double>& values);
+
+/**
+ * @brief Shuffled mini-batch epochs over a model's parameters
+ *
+ * The optimizer is reset for parameters.size() values, then each epoch
+ * optionally reshuffles the rows, hands the new order to reorder() (so the
+ * model can gather its rows and targets once per epoch) and steps the
+ * optimizer after every batch. Training stops early once an epoch's mean
+ * loss falls below the tolerance.
+ *
+ * @param rows Training rows
+ * @param options Batch size, epochs, shuffling and seed
+ * @param tolerance Mean epoch loss that counts as converged
+ * @param reorder Called as reorder(order) after every shuffle; batches then
+ *        cover positions of that order
+ * @param batchLoss Called as batchLoss(begin, end, gradient) for positions
+ *        [begin, end); returns the batch's mean loss and fills the gradient
+ */
+MiniBatchRun runMiniBatches(size_t rows, const MiniBatchOptions& options, double tolerance,
+                            Optimizer& optimizer, std::vector<double>& parameters,
+                            utils::FunctionRef<void(const std::vector<size_t>&)> reorder,
+                            utils::FunctionRef<double(size_t, size_t, std::vector<double>&)> batchLoss);
+
+/**
+ * @brief Mean loss and gradient over rows [0, rows), summed in fixed blocks
+ *
+ * fill(first, count, slot) runs once per block of rows, blocks in parallel,
+ * and adds the block's gradient into slot[0, gradient.size()) and its loss
+ * into slot[gradient.size()]. Blocks hold max(64, ceil(rows / 256)) rows, so
+ * there are at most 256 slots however many rows there are. The
+ * zero-initialised slots are then summed in block order; block size and
+ * order depend only on rows, so the result does not depend on the thread
+ * count.
+ * A block's fill runs on one thread; nested parallel loops inside it stay
+ * serial.
+ *
+ * @param gradient Output, already sized; receives the mean gradient
+ * @param partials Scratch for the per-block slots, reused across calls
+ * @return Mean loss over the rows
+ */
+double reduceBlocks(size_t rows, std::vector<double>& gradient, std::vector<double>& partials,
+                    utils::FunctionRef<void(size_t, size_t, double*)> fill);
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "SpatialIndex.hpp"
+
+namespace ml {
+namespace models {
+
+/**
+ * @brief Build and search settings for HNSWIndex
+ */
+struct HNSWOptions {
+    size_t M = 16;                  ///< Links per node on the upper layers; layer 0 keeps 2M
+    size_t efConstruction = 200;    ///< Candidate list size while inserting
+    size_t efSearch = 64;           ///< Candidate list size while querying (at least k is used)
+    uint64_t seed = 0;              ///< Seed for the node levels
+};
+
+/**
+ * @brief Approximate k-nearest-neighbour index: a hierarchical navigable small-world graph
+ *
+ * Every row is a node on layer 0 and, with geometrically falling
+ * probability, on the layers above it. A query descends greedily from the
+ * single top-layer entry point, then runs a best-first search of width
+ * efSearch on layer 0. Recall rises and speed falls with M, efConstruction
+ * and efSearch.
+ *
+ * Nodes are inserted in parallel, each neighbour list guarded by its own
+ * mutex; with one thread the graph depends only on the data and the seed.
+ * The rows are copied into the index and links are stored as 32-bit row
+ * numbers, so an index holds fewer than 2^32 rows.
+ */
+template <typename T>
+class HNSWIndex {
+public:
+    HNSWIndex() = default;
+
+    /**
+     * @brief Build the graph over a copy of the rows
+     * @param points Reference rows (not referenced after construction)
+     * @param options Graph parameters; efSearch is only the default for query()
+     */
+    HNSWIndex(const utils::BasicMatrixView<T>& points, const HNSWOptions& options);
+
+    /**
+     * @brief Approximate k nearest rows to a point
+     * @param point dims() values
+     * @param k Neighbours wanted; fewer are returned if the index is smaller
+     * @param ef Candidate list size; values below k are raised to k
+     * @param out Receives the neighbours closest first; index is the row in the original points
+     */
+    void query(const T* point, size_t k, size_t ef, std::vector<Neighbor>& out) const;
+
+    bool empty() const { return points_.rows() == 0; }
+    size_t size() const { return points_.rows(); }
+    size_t dims() const { return points_.cols(); }
+
+    /**
+     * @brief The index's copy of the rows, in their original order
+     */
+    const utils::BasicMatrix<T>& points() const { return points_; }
+
+    /**
+     * @brief Bytes held for the copied rows and the links
+     */
+    size_t memoryBytes() const;
+
+private:
+    // Marks visited nodes for one search; reset in O(1) by bumping the epoch
+    struct VisitedSet {
+        std::vector<uint32_t> marks;
+        uint32_t epoch = 0;
+
+        void reset(size_t size);
+        bool insert(uint32_t node);
+    };
+
+    /**
+     * @brief The calling thread's visited set, reset for a graph of the given size
+     */
+    static VisitedSet& visitedSet(size_t size);
+
+    size_t M_ = 16;
+    size_t efConstruction_ = 200;
+    utils::BasicMatrix<T> points_;
+    std::vector<uint8_t> levels_;
+    // Layer 0: per node a count followed by up to 2M links
+    std::vector<uint32_t> base_;
+    // Layers 1..level: per node, level blocks of a count followed by up to M links
+    std::vector<std::vector<uint32_t>> upper_;
+    // One lock per node guarding its links, plus a last one guarding the entry point
+    std::unique_ptr<std::mutex[]> locks_;
+    uint32_t entry_ = 0;
+    size_t maxLevel_ = 0;
+
+    size_t capacity(size_t layer) const { return layer == 0 ? 2 * M_ : M_; }
+    uint32_t* links(uint32_t node, size_t layer);
+    const uint32_t* links(uint32_t node, size_t layer) const;
+
+    double distance(const T* point, uint32_t node) const {
+        return squaredDistance(point, points_.rowPtr(node), points_.cols());
+    }
+
+    void insert(uint32_t node);
+
+    /**
+     * @brief Move greedily towards the point on one layer
+     */
+    uint32_t greedy(const T* point, uint32_t entry, size_t layer, bool locked) const;
+
+    /**
+     * @brief Best-first search of one layer from an entry node
+     * @param locked Take each node's lock while reading its links (during construction)
+     * @param out Receives up to ef candidates, closest first
+     */
+    void searchLayer(const T* point, uint32_t entry, size_t ef, size_t layer, bool locked,
+                     std::vector<Neighbor>& out) const;
+
+    /**
+     * @brief Keep up to `limit` candidates that are closer to the base than to any already kept
+     *
+     * The diversity heuristic from the HNSW paper; it links a node across
+     * clusters instead of only to its tightest cluster.
+     * @param candidates Sorted closest first, distances to the base; replaced by the selection
+     */
+    void selectNeighbors(std::vector<Neighbor>& candidates, size_t limit) const;
+
+    /**
+     * @brief Copy a node's links on a layer, under its lock when locked
+     */
+    void readLinks(uint32_t node, size_t layer, bool locked, std::vector<uint32_t>& out) const;
+};
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
@@ -1,28 +1,178 @@
 #pragma once
 
+#include "HNSWIndex.hpp"
 #include "Model.hpp"
+#include "QuantizedIndex.hpp"
+#include "SpatialIndex.hpp"
 
 namespace ml {
 namespace models {
 
+/**
+ * @brief How KNNClassifier finds the nearest references
+ */
+enum class NeighborSearch {
+    BruteForce,     ///< Distance to every reference row
+    KDTree,         ///< Exact search through a KD-tree built in train()
+    BallTree,       ///< Exact search through a ball tree built in train()
+    Auto,           ///< KD-tree up to 16 features, ball tree above
+    HNSW            ///< Approximate search through an HNSW graph built in train()
+};
+
 class KNNClassifier : public Model {
 public:
-    explicit KNNClassifier(size_t k = 5);
+    /**
+     * @param k Neighbours that vote
+     * @param search Search strategy for dense references; sparse references always use brute force
+     * @param leafSize Maximum rows per tree leaf
+     */
+    explicit KNNClassifier(size_t k = 5,
+                           NeighborSearch search = NeighborSearch::BruteForce,
+                           size_t leafSize = 32);
     ~KNNClassifier() override = default;
 
-    bool train(const utils::Matrix& features,
+    bool train(const utils::MatrixView& features,
+              const std::vector<double>& targets) override;
+
+    bool train(const utils::MatrixViewF& features,
+              const std::vector<double>& targets) override;
+
+    bool train(const utils::SparseMatrix& features,
               const std::vector<double>& targets) override;
 
-    std::vector<double> predict(const utils::Matrix& features) const override;
+    std::vector<double> predict(const utils::MatrixView& features) const override;
+    std::vector<double> predict(const utils::MatrixViewF& features) const override;
+    std::vector<double> predict(const utils::SparseMatrix& features) const override;
     std::vector<double> getParameters() const override;
 
+    /**
+     * @brief Graph parameters for NeighborSearch::HNSW
+     *
+     * M, efConstruction and seed take effect at the next train(); efSearch
+     * applies to the next prediction.
+     */
+    void setHNSWOptions(const HNSWOptions& options);
+
+    /**
+     * @brief Fraction of the exact k nearest references that the configured search finds
+     *
+     * Runs both the configured search and brute force over the queries and
+     * averages the overlap per query. Exact strategies (and sparse
+     * references, which are always searched exhaustively) score 1. Other
+     * strategies compute the reference norms brute force needs on each call.
+     */
+    double recall(const utils::MatrixView& queries) const;
+    double recall(const utils::MatrixViewF& queries) const;
+
+    /**
+     * @brief Store dense references as Int8 or product codes from the next train() on
+     *
+     * Quantized references are scanned exhaustively by asymmetric distance
+     * and replace the search strategy's tree or graph. Without re-ranking
+     * the model keeps no full-precision copy of the training rows, and
+     * recall() then throws std::runtime_error.
+     */
+    void setQuantization(const QuantizationOptions& options);
+
+    /**
+     * @brief Bytes of reference data searched at prediction time
+     *
+     * Counts the model's copy of the reference rows (dense rows searched
+     * directly or re-ranked, the sparse rows) plus any tree, graph or codes
+     * built by train().
+     */
+    size_t referenceBytes() const;
+
 private:
+    enum class Storage {
+        Dense,
+        DenseF,
+        Sparse
+    };
+
+    /**
+     * @brief Dense references of one precision with the index their strategy uses
+     */
+    template <typename T>
+    struct DenseReferences {
+        utils::BasicMatrix<T> features;         ///< Brute force and re-ranking only; indexes keep their own copy
+        SpatialIndex<T> tree;                   ///< KD-tree and ball tree strategies
+        HNSWIndex<T> graph;                     ///< HNSW strategy
+        QuantizedIndex codes;                   ///< Quantized references
+        size_t rerank = 0;                      ///< Shortlist rescored exactly from features
+        std::vector<double> norms;              ///< Squared row norms; brute-force strategy only
+
+        /**
+         * @brief Full-precision rows in training order; empty for trees and unranked codes
+         */
+        utils::BasicMatrixView<T> rows() const {
+            return graph.empty() ? utils::BasicMatrixView<T>(features)
+                                 : utils::BasicMatrixView<T>(graph.points());
+        }
+
+        size_t dims() const {
+            if (!codes.empty()) {
+                return codes.dims();
+            }
+            return tree.empty() ? rows().cols() : tree.dims();
+        }
+
+        size_t memoryBytes() const {
+            return features.rows() * features.stride() * sizeof(T) + norms.size() * sizeof(double) +
+                   tree.memoryBytes() + graph.memoryBytes() + codes.memoryBytes();
+        }
+    };
+
+    static constexpr size_t kAutoKDTreeDims = 16;
+
     size_t k_;
-    utils::Matrix trainFeatures_;
+    NeighborSearch search_;
+    size_t leafSize_;
+    HNSWOptions hnsw_;
+    QuantizationOptions quantization_;
+    Storage storage_ = Storage::Dense;
+    // Only the references matching the last train() call are populated. All
+    // of them are copies, so the caller's training data may be released once
+    // train() returns. Squared row norms are kept only where every query
+    // reads them: sparse references and the dense brute-force strategy.
+    DenseReferences<double> dense_;
+    DenseReferences<float> denseF_;
+    utils::SparseMatrix trainSparse_;
+    std::vector<double> sparseNorms_;
     std::vector<double> trainTargets_;
 
-    static double euclideanDistance(const std::vector<double>& a,
-                                  const std::vector<double>& b);
+    template <typename T>
+    void trainDense(DenseReferences<T>& references, const utils::BasicMatrixView<T>& features);
+
+    template <typename Q>
+    std::vector<double> predictDense(const utils::BasicMatrixView<Q>& queries) const;
+
+    /**
+     * @brief Find the nearest references of every query row
+     * @param exact Use brute force whatever the strategy
+     * @param visit Called as visit(query, neighbors) with the neighbours closest
+     *        first; runs concurrently for different queries
+     */
+    template <typename R, typename Q, typename Visit>
+    void searchDense(const DenseReferences<R>& references,
+                     const utils::BasicMatrixView<Q>& queries,
+                     bool exact, const Visit& visit) const;
+
+    template <typename R, typename Q, typename Visit>
+    void bruteForce(const utils::BasicMatrixView<R>& references,
+                    const std::vector<double>& referenceNorms,
+                    const utils::BasicMatrixView<Q>& queries, const Visit& visit) const;
+
+    template <typename Q>
+    double recallDense(const utils::BasicMatrixView<Q>& queries) const;
+
+    /**
+     * @brief Majority vote among the k nearest candidates
+     *
+     * Equal distances are broken by reference row, so every search strategy
+     * picks the same k neighbours.
+     */
+    double vote(std::vector<Neighbor>& distances) const;
 };
 
 } // namespace models
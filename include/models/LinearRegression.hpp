@@ -1,24 +1,146 @@
 #pragma once
 
 #include "Model.hpp"
+#include "../data/BatchSource.hpp"
+#include "../utils/Span.hpp"
 
 namespace ml {
 namespace models {
 
+/**
+ * @brief Ordinary least squares
+ *
+ * Every fit makes one pass over the rows, accumulating the sufficient
+ * statistics X^T X and X^T y block by block (the intercept column is
+ * implicit), and solves the normal equations by Cholesky. Memory is
+ * O(features^2) whatever the row count. When a feature is nearly a linear
+ * combination of the others, squaring the condition number in X^T X would
+ * cost too many digits, so the solve instead takes a second pass that
+ * factors [X | y] by QR, one block at a time, again in O(features^2) memory.
+ */
 class LinearRegression : public Model {
 public:
     LinearRegression(bool fitIntercept = true);
     ~LinearRegression() override = default;
 
-    bool train(const utils::Matrix& features,
+    bool train(const utils::MatrixView& features,
               const std::vector<double>& targets) override;
 
-    std::vector<double> predict(const utils::Matrix& features) const override;
+    bool train(const utils::MatrixViewF& features,
+              const std::vector<double>& targets) override;
+
+    bool train(const utils::SparseMatrix& features,
+              const std::vector<double>& targets) override;
+
+    /**
+     * @brief Fit from a stream of batches with bounded memory
+     *
+     * Accumulates the sufficient statistics X^T X and X^T y one batch at a
+     * time and solves the normal equations once the source is exhausted;
+     * the result matches a fit on the concatenated data.
+     *
+     * @param source Batch source; rewound before use
+     * @return False if the source produced no rows
+     */
+    bool train(data::BatchSource& source);
+
+    /**
+     * @brief Update the fit with new rows by recursive least squares
+     *
+     * Continues from the last train() call, or starts from scratch on an
+     * untrained model. Each row costs O(features^2) via a Sherman-Morrison
+     * update of (X^T X)^-1, so the model tracks a growing or sliding window
+     * without refitting. Until the rows seen determine a unique solution,
+     * they are only accumulated: an untrained model stays untrained, and
+     * one whose train() rows were rank-deficient keeps its least-squares
+     * solution from QR.
+     *
+     * @param features New rows
+     * @param targets Their targets
+     */
+    void partialFit(const utils::MatrixView& features, const std::vector<double>& targets);
+    void partialFit(const utils::MatrixViewF& features, const std::vector<double>& targets);
+
+    /**
+     * @brief Remove rows previously included in the fit (e.g. ones leaving a sliding window)
+     *
+     * Requires a forgetting factor of 1.
+     * @throws std::runtime_error if removing a row would leave the fit underdetermined;
+     *         rows before it have been removed
+     */
+    void removeRows(const utils::MatrixView& features, const std::vector<double>& targets);
+    void removeRows(const utils::MatrixViewF& features, const std::vector<double>& targets);
+
+    /**
+     * @brief Exponentially down-weight older rows in partialFit
+     *
+     * Each new row scales the weight of everything before it by lambda, so
+     * a row added k rows ago counts lambda^k. 1 (the default) weights all
+     * rows equally; train() itself always weights its rows equally.
+     *
+     * @param lambda Forgetting factor in (0, 1]
+     */
+    void setForgettingFactor(double lambda);
+
+    std::vector<double> predict(const utils::MatrixView& features) const override;
+    std::vector<double> predict(const utils::MatrixViewF& features) const override;
+    std::vector<double> predict(const utils::SparseMatrix& features) const override;
     std::vector<double> getParameters() const override;
 
 private:
     std::vector<double> coefficients_;
     bool fitIntercept_;
+    double forgetting_ = 1.0;
+
+    // Online state. gram_ is the augmented X^T X of the rows fitted so far;
+    // while pending_ the rows do not yet determine a solution and moments_
+    // (X^T y) accumulates alongside. inverse_ is (X^T X)^-1, derived from
+    // gram_ on the first update and then maintained directly.
+    utils::Matrix gram_;
+    std::vector<double> moments_;
+    utils::Matrix inverse_;
+    bool pending_ = false;
+    bool inverseReady_ = false;
+
+    template <typename T>
+    bool fit(const utils::BasicMatrixView<T>& features,
+             const std::vector<double>& targets);
+
+    template <typename T>
+    std::vector<double> predictRows(const utils::BasicMatrixView<T>& features) const;
+
+    /**
+     * @brief Add the rows' contribution to the augmented X^T X and X^T y
+     *
+     * Row blocks are accumulated in parallel into per-chunk partials that
+     * are summed in chunk order.
+     *
+     * @param gram Augmented X^T X, (features + intercept) square
+     * @param moments Augmented X^T y
+     */
+    template <typename T>
+    void accumulate(const utils::BasicMatrixView<T>& features, utils::Span<const double> targets,
+                    utils::Matrix& gram, std::vector<double>& moments) const;
+
+    /**
+     * @brief Solve the normal equations by Cholesky
+     * @return False, leaving the coefficients untouched, if X^T X is too ill-conditioned
+     */
+    bool solveNormalEquations(const utils::Matrix& gram, const std::vector<double>& moments);
+
+    /**
+     * @brief Start online updates from the statistics of a full fit
+     * @param solved Whether the normal equations determined the fit; if not,
+     *        later updates accumulate gram and moments until they do
+     */
+    void resetOnline(utils::Matrix gram, std::vector<double> moments, bool solved);
+
+    /**
+     * @brief Add (sign +1) or remove (sign -1) rows for partialFit/removeRows
+     */
+    template <typename T>
+    void update(const utils::BasicMatrixView<T>& features,
+                const std::vector<double>& targets, double sign);
 };
 
 } // namespace models
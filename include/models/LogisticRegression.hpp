@@ -1,10 +1,34 @@
 #pragma once
 
+#include <memory>
 #include "Model.hpp"
+#include "Optimizer.hpp"
+#include "../data/BatchSource.hpp"
+#include "../utils/Span.hpp"
 
 namespace ml {
 namespace models {
 
+/**
+ * @brief Full-batch method LogisticRegression uses on in-memory dense data
+ */
+enum class LogisticSolver {
+    GradientDescent,  ///< Fixed learning rate; stops once the loss falls below the tolerance
+    LBFGS,            ///< Limited-memory BFGS with a backtracking line search
+    Newton            ///< Newton's method (IRLS) with a backtracking line search
+};
+
+/**
+ * @brief Outcome of the most recent LogisticRegression training run
+ */
+struct SolveStats {
+    size_t iterations = 0;      ///< Iterations, or epochs for mini-batch training
+    double seconds = 0.0;       ///< Wall time of the solve
+    double loss = 0.0;          ///< Mean log-loss at the last evaluated iterate
+    double gradientNorm = 0.0;  ///< Largest absolute gradient entry there (full-batch solvers)
+    bool converged = false;     ///< Whether the stopping criterion was met before the iteration cap
+};
+
 class LogisticRegression : public Model {
 public:
     LogisticRegression(double learningRate = 0.01,
@@ -13,10 +37,64 @@ public:
                       bool fitIntercept = true);
     ~LogisticRegression() override = default;
 
-    bool train(const utils::Matrix& features,
+    bool train(const utils::MatrixView& features,
+              const std::vector<double>& targets) override;
+
+    bool train(const utils::MatrixViewF& features,
               const std::vector<double>& targets) override;
 
-    std::vector<double> predict(const utils::Matrix& features) const override;
+    bool train(const utils::SparseMatrix& features,
+              const std::vector<double>& targets) override;
+
+    /**
+     * @brief Mini-batch gradient descent over a stream of batches
+     *
+     * Takes one gradient step per batch, so only one batch is resident at a
+     * time. Stops early once an epoch's mean log-loss drops below the
+     * tolerance.
+     *
+     * @param source Batch source; rewound at the start of every epoch
+     * @param epochs Passes over the source
+     * @return False if the source produced no rows
+     */
+    bool train(data::BatchSource& source, size_t epochs = 1);
+
+    /**
+     * @brief Train with shuffled mini-batches and an optimizer instead of full-batch gradient descent
+     *
+     * Applies to every later train() call on in-memory data, and to the
+     * update rule of train(BatchSource&). The learning rate and iteration
+     * count given to the constructor are then unused; the tolerance still
+     * stops training once an epoch's mean log-loss falls below it.
+     *
+     * @param optimizer Update rule, reset at the start of every train() call; nullptr restores gradient descent
+     * @param options Batch size, epochs, shuffling and Hogwild
+     */
+    void setOptimizer(std::shared_ptr<Optimizer> optimizer,
+                      MiniBatchOptions options = MiniBatchOptions());
+
+    /**
+     * @brief Choose the full-batch solver used when no optimizer is set
+     *
+     * LBFGS and Newton stop once the largest absolute gradient entry falls
+     * below the tolerance, or when the loss stops changing relative to its
+     * size; both usually need tens of iterations where gradient descent
+     * needs thousands. Newton solves a (features + 1)-square system per
+     * iteration, so prefer LBFGS for wide data. Sparse features always use
+     * gradient descent.
+     *
+     * @param solver Solver for later train() calls
+     */
+    void setSolver(LogisticSolver solver) { solver_ = solver; }
+
+    /**
+     * @brief Iterations, wall time and final loss of the last in-memory train() call
+     */
+    const SolveStats& lastSolveStats() const { return stats_; }
+
+    std::vector<double> predict(const utils::MatrixView& features) const override;
+    std::vector<double> predict(const utils::MatrixViewF& features) const override;
+    std::vector<double> predict(const utils::SparseMatrix& features) const override;
     std::vector<double> getParameters() const override;
 
 private:
@@ -25,10 +103,94 @@ private:
     size_t maxIterations_;
     double tolerance_;
     bool fitIntercept_;
+    std::shared_ptr<Optimizer> optimizer_;
+    MiniBatchOptions miniBatch_;
+    LogisticSolver solver_ = LogisticSolver::GradientDescent;
+    SolveStats stats_;
+    // Gradient-descent scratch, kept between fits
+    std::vector<double> gradient_;
+    std::vector<double> partials_;
+
+    template <typename T>
+    bool fit(const utils::BasicMatrixView<T>& features,
+             const std::vector<double>& targets);
+
+    template <typename T>
+    void fitGradientDescent(const utils::BasicMatrixView<T>& features,
+                            const std::vector<double>& targets);
+
+    template <typename T>
+    void fitLBFGS(const utils::BasicMatrixView<T>& features,
+                  const std::vector<double>& targets);
+
+    template <typename T>
+    void fitNewton(const utils::BasicMatrixView<T>& features,
+                   const std::vector<double>& targets);
+
+    template <typename T>
+    void fitMiniBatch(const utils::BasicMatrixView<T>& features,
+                      const std::vector<double>& targets);
+
+    bool fitMiniBatch(const utils::SparseMatrix& features,
+                      const std::vector<double>& targets);
+
+    bool fitHogwild(const utils::SparseMatrix& features,
+                    const std::vector<double>& targets);
+
+    template <typename T>
+    std::vector<double> predictRows(const utils::BasicMatrixView<T>& features) const;
+
+    template <typename T>
+    void predictInto(const utils::BasicMatrixView<T>& features,
+                     std::vector<double>& predictions) const;
+
+    /**
+     * @brief Mean log-loss and its gradient at the current coefficients, in one pass
+     *
+     * Each row is scored, its error folded into the gradient and its loss
+     * accumulated while it is in cache; the intercept is handled implicitly,
+     * so the features are used as given.
+     *
+     * @param features Training rows
+     * @param targets 0/1 labels, one per row of features
+     * @param begin First row to include
+     * @param end One past the last row to include
+     * @param gradient Output, sized to the coefficients; receives the mean gradient
+     * @param partials Scratch for per-block partial sums, reused across calls
+     * @return Mean log-loss over the rows
+     */
+    template <typename T>
+    double lossAndGradient(const utils::BasicMatrixView<T>& features,
+                           utils::Span<const double> targets,
+                           size_t begin, size_t end,
+                           std::vector<double>& gradient,
+                           std::vector<double>& partials) const;
+
+    /**
+     * @brief Backtracking (Armijo) line search along a descent direction
+     *
+     * On entry coefficients_ is the current iterate, with loss and gradient
+     * already evaluated there. On success coefficients_, loss and gradient
+     * move to the accepted point; on failure coefficients_ is restored.
+     *
+     * @param direction Search direction; must have a negative dot product with gradient
+     * @param step Initial step length
+     * @return False if no step gave a sufficient decrease
+     */
+    template <typename T>
+    bool lineSearch(const utils::BasicMatrixView<T>& features,
+                    const std::vector<double>& targets,
+                    const std::vector<double>& direction, double step,
+                    double& loss, std::vector<double>& gradient,
+                    std::vector<double>& partials);
+
+    /**
+     * @brief Mean Hessian of the log-loss, X^T diag(p (1 - p)) X / n over the intercept-augmented rows
+     */
+    template <typename T>
+    utils::Matrix hessian(const utils::BasicMatrixView<T>& features) const;
 
     static double sigmoid(double x);
-    double computeCost(const utils::Matrix& features,
-                      const std::vector<double>& targets) const;
 };
 
 } // namespace models
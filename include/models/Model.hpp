@@ -3,6 +3,8 @@
 #include <vector>
 #include <memory>
 #include "../utils/Matrix.hpp"
+#include "../utils/MatrixView.hpp"
+#include "../utils/SparseMatrix.hpp"
 
 namespace ml {
 namespace models {
@@ -13,11 +15,13 @@ public:
 
     /**
      * @brief Train the model
-     * @param features Training features
+     * @param features Training features (any Matrix, or a view over one);
+     *        models copy whatever they keep, so the data may be released
+     *        once train() returns
      * @param targets Training targets
      * @return True if training was successful
      */
-    virtual bool train(const utils::Matrix& features,
+    virtual bool train(const utils::MatrixView& features,
                       const std::vector<double>& targets) = 0;
 
     /**
@@ -25,7 +29,56 @@ public:
      * @param features Input features
      * @return Vector of predictions
      */
-    virtual std::vector<double> predict(const utils::Matrix& features) const = 0;
+    virtual std::vector<double> predict(const utils::MatrixView& features) const = 0;
+
+    /**
+     * @brief Train the model on single-precision features
+     *
+     * The default widens the features to double and forwards to the double
+     * overload; models with a native float path override it.
+     *
+     * @param features Training features
+     * @param targets Training targets
+     * @return True if training was successful
+     */
+    virtual bool train(const utils::MatrixViewF& features,
+                      const std::vector<double>& targets) {
+        return train(utils::MatrixView(features.toMatrix<double>()), targets);
+    }
+
+    /**
+     * @brief Make predictions from single-precision features
+     * @param features Input features
+     * @return Vector of predictions
+     */
+    virtual std::vector<double> predict(const utils::MatrixViewF& features) const {
+        return predict(utils::MatrixView(features.toMatrix<double>()));
+    }
+
+    /**
+     * @brief Train the model on sparse features
+     *
+     * The default expands the features to a dense matrix and forwards to the
+     * double overload; models whose cost can scale with the nonzeros
+     * override it.
+     *
+     * @param features Training features
+     * @param targets Training targets
+     * @return True if training was successful
+     */
+    virtual bool train(const utils::SparseMatrix& features,
+                      const std::vector<double>& targets) {
+        return train(utils::MatrixView(features.toDense()), targets);
+    }
+
+    /**
+     * @brief Make predictions from sparse features
+     * @param features Input features
+     * @return Vector of predictions
+     */
+    virtual std::vector<double> predict(const utils::SparseMatrix& features) const {
+        return predict(utils::MatrixView(features.toDense()));
+    }
 
     /**
      * @brief Get the model parameters
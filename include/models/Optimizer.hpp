@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ml {
+namespace models {
+
+/**
+ * @brief Per-epoch multiplier applied to an optimizer's base learning rate
+ */
+class LearningRateSchedule {
+public:
+    /**
+     * @brief Keep the base rate throughout
+     */
+    static LearningRateSchedule constant();
+
+    /**
+     * @brief Multiply the rate by gamma every `every` epochs
+     */
+    static LearningRateSchedule stepDecay(size_t every, double gamma);
+
+    /**
+     * @brief Multiply the rate by gamma every epoch
+     */
+    static LearningRateSchedule exponential(double gamma);
+
+    /**
+     * @brief Scale the rate by 1 / (1 + decay * epoch)
+     */
+    static LearningRateSchedule inverseTime(double decay);
+
+    /**
+     * @brief Anneal from the base rate to minFactor times it over totalEpochs along a half cosine
+     */
+    static LearningRateSchedule cosine(size_t totalEpochs, double minFactor = 0.0);
+
+    /**
+     * @brief Multiplier for an epoch (0-based)
+     */
+    double factor(size_t epoch) const;
+
+private:
+    enum class Kind {
+        Constant,
+        StepDecay,
+        Exponential,
+        InverseTime,
+        Cosine
+    };
+
+    Kind kind_ = Kind::Constant;
+    size_t period_ = 1;
+    double rate_ = 1.0;
+
+    LearningRateSchedule(Kind kind, size_t period, double rate);
+};
+
+/**
+ * @brief Mini-batch training settings for models that accept an Optimizer
+ */
+struct MiniBatchOptions {
+    size_t batchSize = 256;   ///< Rows per update; 0 means the whole training set
+    size_t epochs = 10;       ///< Passes over the training set
+    bool shuffle = true;      ///< Visit rows in a fresh random order every epoch
+    uint64_t seed = 0;        ///< Seed for the row order
+    /**
+     * Sparse inputs only: update the shared coefficients from every thread
+     * without locking, one row at a time (Hogwild). Only the coordinates a
+     * row touches are written, so collisions are rare when the data are
+     * sparse. Updates are plain SGD at the optimizer's scheduled rate;
+     * momentum and Adam state are not applied.
+     */
+    bool hogwild = false;
+};
+
+/**
+ * @brief First-order update rule for a dense parameter vector
+ *
+ * The model computes a gradient and calls step(); the optimizer owns any
+ * per-parameter state (velocity, moment estimates) and the learning rate
+ * schedule. Not thread-safe: give each concurrently trained model its own
+ * optimizer.
+ */
+class Optimizer {
+public:
+    virtual ~Optimizer() = default;
+
+    /**
+     * @brief Clear all state for a new run over the given number of parameters
+     */
+    virtual void reset(size_t parameters);
+
+    /**
+     * @brief Set the learning rate for the coming epoch from the schedule
+     * @param epoch Epoch index (0-based)
+     */
+    void beginEpoch(size_t epoch);
+
+    /**
+     * @brief Apply one update
+     * @param parameters Parameters to update in place
+     * @param gradient Gradient of the loss at parameters (same size)
+     */
+    virtual void step(std::vector<double>& parameters, const std::vector<double>& gradient) = 0;
+
+    /**
+     * @brief Learning rate in effect for the current epoch
+     */
+    double learningRate() const { return learningRate_; }
+
+    void setSchedule(const LearningRateSchedule& schedule) { schedule_ = schedule; }
+
+protected:
+    explicit Optimizer(double learningRate);
+
+    double baseRate_;
+    double learningRate_;
+    LearningRateSchedule schedule_ = LearningRateSchedule::constant();
+    size_t steps_ = 0;
+};
+
+/**
+ * @brief Stochastic gradient descent with optional (Nesterov) momentum
+ */
+class SGD : public Optimizer {
+public:
+    explicit SGD(double learningRate = 0.01, double momentum = 0.0, bool nesterov = false);
+
+    void reset(size_t parameters) override;
+    void step(std::vector<double>& parameters, const std::vector<double>& gradient) override;
+
+private:
+    double momentum_;
+    bool nesterov_;
+    std::vector<double> velocity_;
+};
+
+/**
+ * @brief Adam: per-parameter rates from bias-corrected first and second moment estimates
+ */
+class Adam : public Optimizer {
+public:
+    explicit Adam(double learningRate = 0.001, double beta1 = 0.9,
+                  double beta2 = 0.999, double epsilon = 1e-8);
+
+    void reset(size_t parameters) override;
+    void step(std::vector<double>& parameters, const std::vector<double>& gradient) override;
+
+private:
+    double beta1_;
+    double beta2_;
+    double epsilon_;
+    std::vector<double> firstMoment_;
+    std::vector<double> secondMoment_;
+};
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SpatialIndex.hpp"
+
+namespace ml {
+namespace models {
+
+/**
+ * @brief Compressed encodings for reference rows
+ */
+enum class Quantization {
+    None,       ///< Keep full-precision rows
+    Int8,       ///< One byte per value: per-feature affine map of [min, max] onto 0..255
+    Product     ///< One byte per subspace: nearest of up to 256 k-means centroids
+};
+
+/**
+ * @brief Encoding settings for QuantizedIndex
+ */
+struct QuantizationOptions {
+    Quantization kind = Quantization::None;
+    size_t subspaces = 8;       ///< Product: sub-vectors per row (at most one per feature)
+    size_t centroids = 256;     ///< Product: codebook size per subspace, at most 256
+    size_t iterations = 20;     ///< Product: k-means iterations per codebook
+    /**
+     * Candidates rescored with exact distances before voting; 0 votes on
+     * the approximate distances alone. Re-ranking needs the full-precision
+     * rows, so the model then keeps a copy of them next to the codes.
+     */
+    size_t rerank = 0;
+    uint64_t seed = 0;          ///< Seed for the k-means training sample and initial centroids
+};
+
+/**
+ * @brief Reference rows stored as byte codes and searched by asymmetric distance
+ *
+ * Queries stay in full precision; only the references are compressed.
+ * Each query first tabulates its squared distance to every value a code
+ * byte can stand for: the 256 levels of each feature (Int8) or the
+ * centroids of each subspace (Product). A row's distance is then one table
+ * lookup per code byte, and a scan reads one byte per code instead of 4-8
+ * per value.
+ */
+class QuantizedIndex {
+public:
+    QuantizedIndex() = default;
+
+    /**
+     * @brief Train the codebooks (product codes) and encode every row
+     * @param points Reference rows (not referenced after construction)
+     * @param options Encoding; kind must not be None
+     */
+    template <typename T>
+    QuantizedIndex(const utils::BasicMatrixView<T>& points, const QuantizationOptions& options);
+
+    /**
+     * @brief Rows with the smallest approximate squared distance to a point
+     * @param point dims() values
+     * @param count Candidates wanted; fewer are returned if the index is smaller
+     * @param out Receives the candidates closest first; index is the row in the original points
+     */
+    template <typename T>
+    void query(const T* point, size_t count, std::vector<Neighbor>& out) const;
+
+    bool empty() const { return rows_ == 0; }
+    size_t size() const { return rows_; }
+    size_t dims() const { return dims_; }
+    Quantization kind() const { return kind_; }
+
+    /**
+     * @brief Bytes held for the codes, codebooks and scaling
+     */
+    size_t memoryBytes() const;
+
+private:
+    Quantization kind_ = Quantization::None;
+    size_t rows_ = 0;
+    size_t dims_ = 0;
+    size_t codeSize_ = 0;               ///< Bytes per row
+    std::vector<uint8_t> codes_;        ///< rows x codeSize
+    // Int8: value = offset + step * code
+    std::vector<float> offsets_;
+    std::vector<float> steps_;
+    // Product: subspace s covers features [bounds_[s], bounds_[s + 1]); its
+    // centroids x width codebook starts at centroids_ * bounds_[s]
+    std::vector<size_t> bounds_;
+    size_t centroids_ = 0;
+    std::vector<float> codebooks_;
+
+    template <typename T>
+    void encodeScalar(const utils::BasicMatrixView<T>& points);
+
+    template <typename T>
+    void encodeProduct(const utils::BasicMatrixView<T>& points, const QuantizationOptions& options);
+
+    /**
+     * @brief Approximate squared distances of all rows to a query given its per-row cost function
+     */
+    template <typename Distance>
+    void scan(size_t count, const Distance& distance, std::vector<Neighbor>& out) const;
+};
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
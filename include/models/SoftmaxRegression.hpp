@@ -0,0 +1,132 @@
+#pragma once
+
+#include <memory>
+#include "Model.hpp"
+#include "Optimizer.hpp"
+#include "../utils/Span.hpp"
+
+namespace ml {
+namespace models {
+
+/**
+ * @brief Multinomial logistic (softmax) regression
+ *
+ * All class weight vectors are trained together as one (features + 1) x
+ * classes matrix. Rows are scored a block at a time: the block is packed
+ * into a contiguous buffer, its logits come from a single gemm against the
+ * weight matrix, and a max-shifted softmax turns them into probabilities.
+ * The gradient for the block is another gemm, so a training iteration is
+ * two matrix products per block rather than one pass per class.
+ *
+ * Targets may be any distinct values (e.g. quality scores 3..8); predict()
+ * returns the most probable of them.
+ */
+class SoftmaxRegression : public Model {
+public:
+    SoftmaxRegression(double learningRate = 0.1,
+                      size_t maxIterations = 1000,
+                      double tolerance = 1e-4,
+                      bool fitIntercept = true);
+    ~SoftmaxRegression() override = default;
+
+    using Model::train;
+    using Model::predict;
+
+    /**
+     * @brief Full-batch gradient descent, or mini-batches when an optimizer is set
+     *
+     * Gradient descent stops once the largest absolute gradient entry falls
+     * below the tolerance.
+     */
+    bool train(const utils::MatrixView& features,
+              const std::vector<double>& targets) override;
+
+    bool train(const utils::MatrixViewF& features,
+              const std::vector<double>& targets) override;
+
+    /**
+     * @brief Train with shuffled mini-batches and an optimizer instead of full-batch gradient descent
+     * @param optimizer Update rule, reset at the start of every train() call; nullptr restores gradient descent
+     * @param options Batch size, epochs and shuffling (hogwild is ignored)
+     */
+    void setOptimizer(std::shared_ptr<Optimizer> optimizer,
+                      MiniBatchOptions options = MiniBatchOptions());
+
+    /**
+     * @brief Most probable class label for each row
+     */
+    std::vector<double> predict(const utils::MatrixView& features) const override;
+    std::vector<double> predict(const utils::MatrixViewF& features) const override;
+
+    /**
+     * @brief Class probabilities for each row
+     * @return rows x classes matrix; column c corresponds to classes()[c]
+     */
+    utils::Matrix predictProbabilities(const utils::MatrixView& features) const;
+    utils::Matrix predictProbabilities(const utils::MatrixViewF& features) const;
+
+    /**
+     * @brief Distinct target values seen in training, in ascending order
+     */
+    const std::vector<double>& classes() const { return classes_; }
+
+    /**
+     * @brief Weight matrix, row-major (features + 1) x classes; row 0 holds the intercepts when fitted
+     */
+    std::vector<double> getParameters() const override;
+
+private:
+    std::vector<double> classes_;
+    std::vector<double> weights_;
+    size_t features_ = 0;
+    double learningRate_;
+    size_t maxIterations_;
+    double tolerance_;
+    bool fitIntercept_;
+    std::shared_ptr<Optimizer> optimizer_;
+    MiniBatchOptions miniBatch_;
+    // Training scratch, kept between fits
+    std::vector<size_t> labels_;
+    std::vector<double> gradient_;
+    std::vector<double> partials_;
+
+    template <typename T>
+    bool fit(const utils::BasicMatrixView<T>& features,
+             const std::vector<double>& targets);
+
+    template <typename T>
+    void fitMiniBatch(const utils::BasicMatrixView<T>& features,
+                      const std::vector<size_t>& labels);
+
+    /**
+     * @brief Mean cross-entropy and its gradient over rows [begin, end), in one pass
+     * @param labels Class index of every row of features
+     * @param gradient Output, sized like the weights
+     * @param partials Scratch for per-block partial sums, reused across calls
+     * @return Mean cross-entropy over the rows
+     */
+    template <typename T>
+    double lossAndGradient(const utils::BasicMatrixView<T>& features,
+                           utils::Span<const size_t> labels,
+                           size_t begin, size_t end,
+                           std::vector<double>& gradient,
+                           std::vector<double>& partials) const;
+
+    /**
+     * @brief Softmax probabilities of rows [begin, begin + count) into probabilities
+     * @param block Scratch receiving the packed rows (grown as needed)
+     * @param probabilities Output; its first count rows receive the probabilities (grown as needed)
+     */
+    template <typename T>
+    void scoreBlock(const utils::BasicMatrixView<T>& features, size_t begin, size_t count,
+                    utils::Matrix& block, utils::Matrix& probabilities) const;
+
+    template <typename T>
+    utils::Matrix probabilities(const utils::BasicMatrixView<T>& features) const;
+
+    template <typename T>
+    std::vector<double> predictRows(const utils::BasicMatrixView<T>& features) const;
+};
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "../utils/Matrix.hpp"
+#include "../utils/MatrixView.hpp"
+
+namespace ml {
+namespace models {
+
+/**
+ * @brief A reference row and its squared Euclidean distance to a query
+ *
+ * Ordered by distance, then by row, so ties resolve the same way in every
+ * search strategy.
+ */
+struct Neighbor {
+    double distance;
+    size_t index;
+};
+
+inline bool operator<(const Neighbor& a, const Neighbor& b) {
+    return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+}
+
+/**
+ * @brief Squared Euclidean distance between two rows, accumulated in double
+ */
+template <typename T>
+inline double squaredDistance(const T* a, const T* b, size_t dims) {
+    double sum = 0.0;
+    for (size_t c = 0; c < dims; ++c) {
+        const double diff = static_cast<double>(a[c]) - static_cast<double>(b[c]);
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+/**
+ * @brief Bounded max-heap holding the k closest neighbours seen so far
+ */
+class NeighborHeap {
+public:
+    explicit NeighborHeap(size_t k = 0) { reset(k); }
+
+    /**
+     * @brief Empty the heap and set its capacity
+     */
+    void reset(size_t k) {
+        k_ = k;
+        heap_.clear();
+        heap_.reserve(k);
+    }
+
+    bool full() const { return heap_.size() >= k_; }
+
+    /**
+     * @brief Distance a candidate must beat once the heap is full
+     */
+    double worst() const { return heap_.front().distance; }
+
+    void push(double distance, size_t index) {
+        const Neighbor candidate{distance, index};
+        if (!full()) {
+            heap_.push_back(candidate);
+            std::push_heap(heap_.begin(), heap_.end());
+        } else if (k_ > 0 && candidate < heap_.front()) {
+            std::pop_heap(heap_.begin(), heap_.end());
+            heap_.back() = candidate;
+            std::push_heap(heap_.begin(), heap_.end());
+        }
+    }
+
+    /**
+     * @brief Move the neighbours out, closest first, leaving the heap empty
+     */
+    void sortedInto(std::vector<Neighbor>& out) {
+        std::sort_heap(heap_.begin(), heap_.end());
+        out.assign(heap_.begin(), heap_.end());
+        heap_.clear();
+    }
+
+private:
+    size_t k_ = 0;
+    std::vector<Neighbor> heap_;
+};
+
+enum class SpatialIndexKind {
+    KDTree,     ///< Axis-aligned bounding boxes; prunes well up to ~16 dimensions
+    BallTree    ///< Centre and radius per node; degrades more gracefully with dimension
+};
+
+/**
+ * @brief Exact k-nearest-neighbour index over dense rows
+ *
+ * Both kinds share one build: each node splits its rows at the median of
+ * the dimension with the widest extent until at most leafSize rows remain.
+ * Nodes are stored depth-first in one array (the left child directly
+ * follows its parent) and the rows are copied in leaf order, so every leaf
+ * bucket is one contiguous block of the index's own matrix. A query
+ * descends the nearer child first and skips any node whose distance lower
+ * bound cannot beat the current k-th best.
+ */
+template <typename T>
+class SpatialIndex {
+public:
+    SpatialIndex() = default;
+
+    /**
+     * @brief Build an index over a copy of the rows
+     * @param points Reference rows (not referenced after construction)
+     * @param kind Bounding geometry used for pruning
+     * @param leafSize Maximum rows per leaf
+     */
+    SpatialIndex(const utils::BasicMatrixView<T>& points, SpatialIndexKind kind,
+                 size_t leafSize = 32);
+
+    /**
+     * @brief Exact k nearest rows to a point
+     * @param point dims() values
+     * @param k Neighbours wanted; fewer are returned if the index is smaller
+     * @param out Receives the neighbours closest first; index is the row in the original points
+     */
+    void query(const T* point, size_t k, std::vector<Neighbor>& out) const;
+
+    bool empty() const { return nodes_.empty(); }
+    size_t size() const { return order_.size(); }
+    size_t dims() const { return dims_; }
+    SpatialIndexKind kind() const { return kind_; }
+
+    /**
+     * @brief Bytes held for the copied rows and the nodes
+     */
+    size_t memoryBytes() const;
+
+private:
+    struct Node {
+        size_t begin;       ///< First row (in leaf order) under this node
+        size_t end;         ///< One past the last row
+        size_t right;       ///< Right child; 0 for a leaf (the left child is this node + 1)
+        double radius;      ///< Ball tree only
+    };
+
+    SpatialIndexKind kind_ = SpatialIndexKind::KDTree;
+    size_t dims_ = 0;
+    size_t leafSize_ = 32;
+    std::vector<Node> nodes_;
+    // Per node: lower then upper box corner (KD-tree) or the centre (ball tree)
+    std::vector<double> geometry_;
+    utils::BasicMatrix<T> points_;
+    std::vector<size_t> order_;
+
+    size_t stride() const { return kind_ == SpatialIndexKind::KDTree ? 2 * dims_ : dims_; }
+
+    size_t build(const utils::BasicMatrixView<T>& points, size_t begin, size_t end);
+
+    /**
+     * @brief Smallest squared distance from the point to anything under the node
+     */
+    double lowerBound(size_t node, const T* point) const;
+
+    void search(size_t node, const T* point, double bound, NeighborHeap& heap) const;
+};
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <limits>
+#include <type_traits>
+#include "Workspace.hpp"
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Standard-conforming allocator returning over-aligned storage
+ *
+ * Used as the backing allocator for Matrix so that every row buffer starts
+ * on a cache line and vector loads in the numeric kernels never split lines.
+ * Cache-line aligned requests go through the calling thread's Workspace
+ * when one is active.
+ *
+ * @tparam T Element type
+ * @tparam Alignment Byte alignment (must be a power of two)
+ */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    static constexpr std::size_t alignment = Alignment;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(size_type n) {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if (Alignment == Workspace::kAlignment) {
+            if (Workspace* workspace = Workspace::current()) {
+                return static_cast<T*>(workspace->allocate(n * sizeof(T)));
+            }
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* ptr, size_type n) noexcept {
+        if (Alignment == Workspace::kAlignment) {
+            if (Workspace* workspace = Workspace::current()) {
+                workspace->deallocate(ptr, n * sizeof(T));
+                return;
+            }
+        }
+        ::operator delete(ptr, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
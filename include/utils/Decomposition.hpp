@@ -0,0 +1,209 @@
+#pragma once
+
+#include <vector>
+#include "Matrix.hpp"
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief LU factorization with partial pivoting: P * A = L * U
+ *
+ * Blocked right-looking algorithm; the trailing update of each block
+ * column goes through gemm. A singular input is factorized anyway and
+ * reported by isSingular(); solve() and inverse() throw on it.
+ */
+class LUDecomposition {
+public:
+    /**
+     * @brief Factorize a square matrix
+     * @param matrix Input matrix
+     */
+    explicit LUDecomposition(const Matrix& matrix);
+
+    /**
+     * @brief Whether an exactly zero pivot was encountered
+     */
+    bool isSingular() const { return singular_; }
+
+    /**
+     * @brief Solve A * X = B for every column of B
+     * @param rhs Right-hand sides (n x r)
+     * @return Solution matrix (n x r)
+     */
+    Matrix solve(const Matrix& rhs) const;
+
+    /**
+     * @brief Solve A * x = b for a single right-hand side
+     * @param rhs Right-hand side vector
+     * @return Solution vector
+     */
+    std::vector<double> solve(const std::vector<double>& rhs) const;
+
+    /**
+     * @brief Inverse of the factorized matrix
+     * @return A^-1
+     */
+    Matrix inverse() const;
+
+    /**
+     * @brief Determinant from the product of U's diagonal
+     */
+    double determinant() const;
+
+    /**
+     * @brief Natural log of |det(A)| (-inf when singular)
+     */
+    double logDeterminant() const;
+
+    /**
+     * @brief Sign of det(A): -1, 0 or 1
+     */
+    int determinantSign() const;
+
+    /**
+     * @brief Unit lower triangular factor
+     */
+    Matrix L() const;
+
+    /**
+     * @brief Upper triangular factor
+     */
+    Matrix U() const;
+
+    /**
+     * @brief Row permutation: row i of P * A is row pivots()[i] of A
+     */
+    const std::vector<size_t>& pivots() const { return permutation_; }
+
+private:
+    Matrix lu_;
+    std::vector<size_t> permutation_;
+    int pivotSign_;
+    bool singular_;
+};
+
+/**
+ * @brief Cholesky factorization of a symmetric positive definite matrix: A = L * L^T
+ *
+ * Only the lower triangle of the input is read. Blocked right-looking
+ * algorithm with gemm trailing updates. A matrix that is not positive
+ * definite is reported by isPositiveDefinite(); solve() throws on it.
+ */
+class CholeskyDecomposition {
+public:
+    /**
+     * @brief Factorize a symmetric matrix
+     * @param matrix Input matrix
+     */
+    explicit CholeskyDecomposition(const Matrix& matrix);
+
+    /**
+     * @brief Whether the factorization succeeded
+     */
+    bool isPositiveDefinite() const { return positiveDefinite_; }
+
+    /**
+     * @brief Solve A * X = B for every column of B
+     * @param rhs Right-hand sides (n x r)
+     * @return Solution matrix (n x r)
+     */
+    Matrix solve(const Matrix& rhs) const;
+
+    /**
+     * @brief Solve A * x = b for a single right-hand side
+     * @param rhs Right-hand side vector
+     * @return Solution vector
+     */
+    std::vector<double> solve(const std::vector<double>& rhs) const;
+
+    /**
+     * @brief Inverse of the factorized matrix
+     * @return A^-1
+     */
+    Matrix inverse() const;
+
+    /**
+     * @brief Determinant, the squared product of L's diagonal
+     */
+    double determinant() const;
+
+    /**
+     * @brief Natural log of det(A), 2 * sum(log(L_ii))
+     */
+    double logDeterminant() const;
+
+    /**
+     * @brief Lower triangular factor
+     */
+    Matrix L() const;
+
+private:
+    Matrix l_;
+    bool positiveDefinite_;
+};
+
+/**
+ * @brief Householder QR factorization of an m x n matrix (m >= n): A = Q * R
+ *
+ * Reflectors are applied a block at a time in compact WY form, so the
+ * bulk of the work is two gemm calls per block column. solve() returns
+ * the least-squares solution for overdetermined systems.
+ */
+class QRDecomposition {
+public:
+    /**
+     * @brief Factorize a matrix with at least as many rows as columns
+     * @param matrix Input matrix
+     */
+    explicit QRDecomposition(const Matrix& matrix);
+
+    /**
+     * @brief Whether every diagonal entry of R is non-negligible
+     */
+    bool isFullRank() const;
+
+    /**
+     * @brief Least-squares solution of A * X = B for every column of B
+     * @param rhs Right-hand sides (m x r)
+     * @return Solution matrix (n x r)
+     */
+    Matrix solve(const Matrix& rhs) const;
+
+    /**
+     * @brief Least-squares solution of A * x = b
+     * @param rhs Right-hand side vector (length m)
+     * @return Solution vector (length n)
+     */
+    std::vector<double> solve(const std::vector<double>& rhs) const;
+
+    /**
+     * @brief Determinant of a square input
+     */
+    double determinant() const;
+
+    /**
+     * @brief Natural log of |det(A)| for a square input
+     */
+    double logDeterminant() const;
+
+    /**
+     * @brief Upper triangular factor (n x n)
+     */
+    Matrix R() const;
+
+    /**
+     * @brief Thin orthogonal factor (m x n)
+     */
+    Matrix Q() const;
+
+private:
+    Matrix qr_;              // R on and above the diagonal, reflectors below
+    std::vector<double> tau_;
+
+    void applyQTranspose(Matrix& rhs) const;
+    void solveR(Matrix& rhs) const;
+};
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ml {
+namespace utils {
+
+template <typename Signature>
+class FunctionRef;
+
+/**
+ * @brief Non-owning reference to a callable
+ *
+ * A pointer to the callable plus a call trampoline; unlike std::function it
+ * never allocates, whatever the callable captures. The callable must outlive
+ * the reference, so take FunctionRef only as a parameter that is invoked
+ * before the call returns.
+ */
+template <typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+public:
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<F>, FunctionRef>::value>>
+    FunctionRef(F&& f)
+        : callable_(const_cast<void*>(static_cast<const void*>(std::addressof(f)))),
+          call_([](void* callable, Args... args) -> R {
+              return (*static_cast<std::remove_reference_t<F>*>(callable))(
+                  std::forward<Args>(args)...);
+          }) {}
+
+    R operator()(Args... args) const {
+        return call_(callable_, std::forward<Args>(args)...);
+    }
+
+private:
+    void* callable_;
+    R (*call_)(void*, Args...);
+};
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
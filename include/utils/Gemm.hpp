@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Matrix.hpp"
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Whether a GEMM operand is used as stored or transposed
+ */
+enum class Transpose {
+    No,
+    Yes
+};
+
+/**
+ * @brief Micro-kernel family used by gemm()
+ *
+ * Auto picks the widest instruction set the running CPU supports.
+ */
+enum class GemmKernel {
+    Auto,
+    Scalar,
+    AVX2,
+    AVX512
+};
+
+/**
+ * @brief General matrix multiply: C = alpha * op(A) * op(B) + beta * C
+ *
+ * Operands are packed into cache-sized panels and multiplied with a
+ * register-tiled micro-kernel, so op(A) and op(B) never need to be
+ * materialized. When beta is zero C is overwritten (and resized if its
+ * shape does not match); otherwise C must already be m x n.
+ *
+ * @param alpha Scale applied to op(A) * op(B)
+ * @param A Left operand
+ * @param transA Whether to use A transposed
+ * @param B Right operand
+ * @param transB Whether to use B transposed
+ * @param beta Scale applied to the existing contents of C
+ * @param C Output matrix
+ */
+void gemm(double alpha, const Matrix& A, Transpose transA,
+          const Matrix& B, Transpose transB,
+          double beta, Matrix& C);
+
+/**
+ * @brief Single-precision GEMM; float tiles are twice as wide per register
+ */
+void gemm(float alpha, const MatrixF& A, Transpose transA,
+          const MatrixF& B, Transpose transB,
+          float beta, MatrixF& C);
+
+/**
+ * @brief Pointer-level GEMM on row-major blocks with explicit leading dimensions
+ *
+ * Same semantics as the Matrix overload, but operates on sub-blocks of
+ * larger buffers (e.g. the trailing update of a blocked factorization).
+ * C must not overlap A or B.
+ *
+ * @param m Rows of op(A) and C
+ * @param n Columns of op(B) and C
+ * @param k Columns of op(A) / rows of op(B)
+ * @param alpha Scale applied to op(A) * op(B)
+ * @param A Pointer to the first element of A
+ * @param lda Distance between consecutive rows of A as stored
+ * @param transA Whether to use A transposed
+ * @param B Pointer to the first element of B
+ * @param ldb Distance between consecutive rows of B as stored
+ * @param transB Whether to use B transposed
+ * @param beta Scale applied to the existing contents of C
+ * @param C Pointer to the first element of C
+ * @param ldc Distance between consecutive rows of C
+ */
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t lda, Transpose transA,
+          const double* B, size_t ldb, Transpose transB,
+          double beta, double* C, size_t ldc);
+
+void gemm(size_t m, size_t n, size_t k, float alpha,
+          const float* A, size_t lda, Transpose transA,
+          const float* B, size_t ldb, Transpose transB,
+          float beta, float* C, size_t ldc);
+
+/**
+ * @brief Force a specific micro-kernel (Auto restores CPU detection)
+ * @param kernel Kernel family; unsupported choices fall back to Scalar
+ */
+void setGemmKernel(GemmKernel kernel);
+
+/**
+ * @brief Name of the micro-kernel gemm() currently dispatches to
+ * @return "scalar", "avx2" or "avx512"
+ */
+const char* gemmKernelName();
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
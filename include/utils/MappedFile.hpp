@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * The mapping is private and read-only; pages are faulted in on demand, so
+ * opening a multi-gigabyte file is cheap and parallel readers share the page
+ * cache instead of copying through stream buffers.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /**
+     * @brief Map a file
+     * @param path Path to the file
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief First byte of the mapping (nullptr for an empty file)
+     */
+    const char* data() const { return data_; }
+
+    /**
+     * @brief Size of the file in bytes
+     */
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+
+    void unmap() noexcept;
+};
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
@@ -3,70 +3,254 @@
 #include <vector>
 #include <iostream>
 #include <stdexcept>
+#include "AlignedAllocator.hpp"
+#include "MatrixExpr.hpp"
+#include "Span.hpp"
 
 namespace ml {
 namespace utils {
 
-class Matrix {
+/**
+ * @brief Dense row-major matrix of float or double
+ *
+ * Elements live in a single cache-line aligned buffer; row i starts at
+ * data() + i * stride(). Row access returns a Span into that buffer rather
+ * than a separately allocated vector.
+ *
+ * Element-wise arithmetic (+, -, scalar * and /) returns a MatrixExpr that
+ * is evaluated in a single fused pass on assignment; only matrix products
+ * produce a matrix directly.
+ *
+ * Explicitly instantiated for float and double; use the Matrix and MatrixF
+ * aliases.
+ *
+ * @tparam T Element type
+ */
+template <typename T>
+class BasicMatrix : public MatrixExpr<BasicMatrix<T>> {
 public:
+    using value_type = T;
+    using Storage = std::vector<T, AlignedAllocator<T>>;
+
     /**
      * @brief Construct a new Matrix object
      * @param rows Number of rows
      * @param cols Number of columns
      */
-    Matrix(size_t rows = 0, size_t cols = 0);
+    BasicMatrix(size_t rows = 0, size_t cols = 0);
     
     /**
      * @brief Construct a Matrix from vector of vectors
      * @param data Input data
      */
-    explicit Matrix(const std::vector<std::vector<double>>& data);
+    explicit BasicMatrix(const std::vector<std::vector<T>>& data);
+
+    /**
+     * @brief Evaluate an element-wise expression into a new Matrix
+     * @param expr Expression to evaluate
+     */
+    template <typename E>
+    BasicMatrix(const MatrixExpr<E>& expr);
 
     // Rule of five
-    Matrix(const Matrix& other);
-    Matrix(Matrix&& other) noexcept;
-    Matrix& operator=(const Matrix& other);
-    Matrix& operator=(Matrix&& other) noexcept;
-    ~Matrix() = default;
+    BasicMatrix(const BasicMatrix& other);
+    BasicMatrix(BasicMatrix&& other) noexcept;
+    BasicMatrix& operator=(const BasicMatrix& other);
+    BasicMatrix& operator=(BasicMatrix&& other) noexcept;
+    ~BasicMatrix() = default;
+
+    /**
+     * @brief Evaluate an expression into this matrix, reusing its buffer
+     *
+     * Safe when the expression refers to this matrix, since every element
+     * depends only on the same position of its operands.
+     *
+     * @param expr Expression to evaluate
+     * @return Reference to this matrix
+     */
+    template <typename E>
+    BasicMatrix& operator=(const MatrixExpr<E>& expr);
 
     // Basic operations
-    Matrix operator+(const Matrix& other) const;
-    Matrix operator-(const Matrix& other) const;
-    Matrix operator*(const Matrix& other) const;
-    Matrix operator*(double scalar) const;
-    Matrix& operator+=(const Matrix& other);
-    Matrix& operator-=(const Matrix& other);
-    Matrix& operator*=(double scalar);
+    BasicMatrix operator*(const BasicMatrix& other) const;
+    ScalarExpr<BasicMatrix, detail::Scale> operator*(T scalar) const;
+    template <typename E>
+    BasicMatrix& operator+=(const MatrixExpr<E>& expr);
+    template <typename E>
+    BasicMatrix& operator-=(const MatrixExpr<E>& expr);
+    BasicMatrix& operator*=(T scalar);
 
     // Access operators
-    std::vector<double>& operator[](size_t row);
-    const std::vector<double>& operator[](size_t row) const;
+    /**
+     * @brief Bounds-checked row access
+     * @param row Row index
+     * @return Span over the row's elements
+     */
+    Span<T> operator[](size_t row);
+    Span<const T> operator[](size_t row) const;
+
+    /**
+     * @brief Unchecked element access for inner loops
+     * @param row Row index
+     * @param col Column index
+     * @return Reference to the element
+     */
+    T& operator()(size_t row, size_t col) noexcept { return data_[row * stride_ + col]; }
+    T operator()(size_t row, size_t col) const noexcept { return data_[row * stride_ + col]; }
+
+    /**
+     * @brief Unchecked pointer to the first element of a row
+     * @param row Row index
+     */
+    T* rowPtr(size_t row) noexcept { return data_.data() + row * stride_; }
+    const T* rowPtr(size_t row) const noexcept { return data_.data() + row * stride_; }
+
+    /**
+     * @brief Raw pointer to the underlying buffer
+     */
+    T* data() noexcept { return data_.data(); }
+    const T* data() const noexcept { return data_.data(); }
 
     // Matrix operations
-    Matrix transpose() const;
-    Matrix inverse() const;
+    BasicMatrix transpose() const;
+
+    /**
+     * @brief Inverse via LU decomposition with partial pivoting
+     *
+     * Float matrices are factorized in double precision.
+     *
+     * @return Inverse matrix
+     */
+    BasicMatrix inverse() const;
+
+    /**
+     * @brief Determinant via LU decomposition (O(n^3), computed in double)
+     * @return Determinant value
+     */
     double determinant() const;
+
+    /**
+     * @brief Element-wise conversion to another scalar type
+     * @tparam U Target element type
+     */
+    template <typename U>
+    BasicMatrix<U> cast() const;
     
     // Static methods
-    static Matrix identity(size_t size);
-    static Matrix zeros(size_t rows, size_t cols);
-    static Matrix ones(size_t rows, size_t cols);
+    static BasicMatrix identity(size_t size);
+    static BasicMatrix zeros(size_t rows, size_t cols);
+    static BasicMatrix ones(size_t rows, size_t cols);
 
     // Utility methods
     size_t rows() const { return rows_; }
     size_t cols() const { return cols_; }
+    size_t stride() const { return stride_; }
+    size_t size() const { return rows_ * cols_; }
+
+    /**
+     * @brief Reinterpret the matrix with new dimensions (no data movement)
+     * @param rows New number of rows
+     * @param cols New number of columns
+     */
     void reshape(size_t rows, size_t cols);
-    
-    // I/O operations
-    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix);
 
 private:
     size_t rows_;
     size_t cols_;
-    std::vector<std::vector<double>> data_;
+    size_t stride_;
+    Storage data_;
+
+    void validateDimensions(const BasicMatrix& other) const;
 
-    void validateDimensions(const Matrix& other) const;
+    template <typename E, typename Op>
+    void evaluate(const E& expr, Op op);
 };
 
+using Matrix = BasicMatrix<double>;
+using MatrixF = BasicMatrix<float>;
+
+// I/O operations
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const BasicMatrix<T>& matrix);
+
+template <typename T>
+template <typename E, typename Op>
+void BasicMatrix<T>::evaluate(const E& expr, Op op) {
+    detail::forRows(rows_, cols_, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* out = rowPtr(i);
+            for (size_t j = 0; j < cols_; ++j) {
+                out[j] = op(out[j], static_cast<T>(expr(i, j)));
+            }
+        }
+    });
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>::BasicMatrix(const MatrixExpr<E>& expr)
+    : rows_(expr.rows()), cols_(expr.cols()), stride_(expr.cols()),
+      data_(expr.rows() * expr.cols()) {
+    evaluate(expr.derived(), [](T, T value) { return value; });
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator=(const MatrixExpr<E>& expr) {
+    const E& e = expr.derived();
+    if (rows_ != e.rows() || cols_ != e.cols()) {
+        rows_ = e.rows();
+        cols_ = e.cols();
+        stride_ = cols_;
+        data_.resize(rows_ * cols_);
+    }
+    evaluate(e, [](T, T value) { return value; });
+    return *this;
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator+=(const MatrixExpr<E>& expr) {
+    const E& e = expr.derived();
+    if (rows_ != e.rows() || cols_ != e.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match");
+    }
+    evaluate(e, [](T current, T value) { return current + value; });
+    return *this;
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator-=(const MatrixExpr<E>& expr) {
+    const E& e = expr.derived();
+    if (rows_ != e.rows() || cols_ != e.cols()) {
+        throw std::invalid_argument("Matrix dimensions must match");
+    }
+    evaluate(e, [](T current, T value) { return current - value; });
+    return *this;
+}
+
+template <typename T>
+ScalarExpr<BasicMatrix<T>, detail::Scale> BasicMatrix<T>::operator*(T scalar) const {
+    return ScalarExpr<BasicMatrix<T>, detail::Scale>(*this, scalar);
+}
+
+template <typename T>
+template <typename U>
+BasicMatrix<U> BasicMatrix<T>::cast() const {
+    BasicMatrix<U> result(rows_, cols_);
+    for (size_t i = 0; i < rows_; ++i) {
+        const T* in = rowPtr(i);
+        U* out = result.rowPtr(i);
+        for (size_t j = 0; j < cols_; ++j) {
+            out[j] = static_cast<U>(in[j]);
+        }
+    }
+    return result;
+}
+
+extern template class BasicMatrix<float>;
+extern template class BasicMatrix<double>;
+
 } // namespace utils
 } // namespace ml
\ No newline at end of file
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "ThreadPool.hpp"
+
+namespace ml {
+namespace utils {
+
+template <typename T>
+class BasicMatrix;
+
+/**
+ * @brief CRTP base for lazily evaluated element-wise matrix expressions
+ *
+ * Arithmetic on Matrix builds a tree of these nodes instead of allocating a
+ * temporary per operator; the tree is evaluated in one fused loop when it is
+ * assigned to a Matrix. Operands are held by reference, so an expression
+ * must be consumed within the statement that creates it (do not store one
+ * in an `auto` variable).
+ *
+ * @tparam Derived Concrete expression type
+ */
+template <typename Derived>
+class MatrixExpr {
+public:
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+    size_t rows() const { return derived().rows(); }
+    size_t cols() const { return derived().cols(); }
+};
+
+namespace detail {
+
+// Element-wise work below this many entries stays on the calling thread
+constexpr size_t kParallelElements = size_t(1) << 15;
+
+// Run fn(rowBegin, rowEnd) over all rows, in parallel for large matrices
+template <typename Fn>
+void forRows(size_t rows, size_t cols, Fn&& fn) {
+    if (rows * cols < kParallelElements) {
+        fn(0, rows);
+        return;
+    }
+    size_t grain = std::max<size_t>(1, kParallelElements / std::max<size_t>(cols, 1));
+    parallelFor(0, rows, grain, fn);
+}
+
+// Matrices are captured by reference, intermediate nodes by value
+template <typename E>
+struct ExprOperand {
+    using type = const E;
+};
+
+template <typename T>
+struct ExprOperand<BasicMatrix<T>> {
+    using type = const BasicMatrix<T>&;
+};
+
+// Scalar type an expression evaluates to
+template <typename E>
+struct ExprValue;
+
+template <typename T>
+struct ExprValue<BasicMatrix<T>> {
+    using type = T;
+};
+
+template <typename E>
+using ExprValueT = typename ExprValue<E>::type;
+
+struct Add {
+    template <typename T>
+    static T apply(T a, T b) { return a + b; }
+};
+
+struct Subtract {
+    template <typename T>
+    static T apply(T a, T b) { return a - b; }
+};
+
+struct Scale {
+    template <typename T>
+    static T apply(T a, T scalar) { return a * scalar; }
+};
+
+struct Divide {
+    template <typename T>
+    static T apply(T a, T scalar) { return a / scalar; }
+};
+
+} // namespace detail
+
+/**
+ * @brief Element-wise combination of two same-shaped expressions
+ */
+template <typename L, typename R, typename Op>
+class BinaryExpr : public MatrixExpr<BinaryExpr<L, R, Op>> {
+public:
+    using value_type = std::common_type_t<detail::ExprValueT<L>, detail::ExprValueT<R>>;
+
+    BinaryExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+        if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+            throw std::invalid_argument("Matrix dimensions must match");
+        }
+    }
+
+    size_t rows() const { return lhs_.rows(); }
+    size_t cols() const { return lhs_.cols(); }
+    value_type operator()(size_t row, size_t col) const {
+        return Op::apply(static_cast<value_type>(lhs_(row, col)),
+                         static_cast<value_type>(rhs_(row, col)));
+    }
+
+private:
+    typename detail::ExprOperand<L>::type lhs_;
+    typename detail::ExprOperand<R>::type rhs_;
+};
+
+/**
+ * @brief Element-wise combination of an expression with a scalar
+ */
+template <typename E, typename Op>
+class ScalarExpr : public MatrixExpr<ScalarExpr<E, Op>> {
+public:
+    using value_type = detail::ExprValueT<E>;
+
+    ScalarExpr(const E& expr, value_type scalar) : expr_(expr), scalar_(scalar) {}
+
+    size_t rows() const { return expr_.rows(); }
+    size_t cols() const { return expr_.cols(); }
+    value_type operator()(size_t row, size_t col) const {
+        return Op::apply(expr_(row, col), scalar_);
+    }
+
+private:
+    typename detail::ExprOperand<E>::type expr_;
+    value_type scalar_;
+};
+
+namespace detail {
+
+template <typename L, typename R, typename Op>
+struct ExprValue<BinaryExpr<L, R, Op>> {
+    using type = typename BinaryExpr<L, R, Op>::value_type;
+};
+
+template <typename E, typename Op>
+struct ExprValue<ScalarExpr<E, Op>> {
+    using type = ExprValueT<E>;
+};
+
+} // namespace detail
+
+template <typename L, typename R>
+BinaryExpr<L, R, detail::Add> operator+(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    return BinaryExpr<L, R, detail::Add>(lhs.derived(), rhs.derived());
+}
+
+template <typename L, typename R>
+BinaryExpr<L, R, detail::Subtract> operator-(const MatrixExpr<L>& lhs, const MatrixExpr<R>& rhs) {
+    return BinaryExpr<L, R, detail::Subtract>(lhs.derived(), rhs.derived());
+}
+
+template <typename E>
+ScalarExpr<E, detail::Scale> operator*(const MatrixExpr<E>& expr, detail::ExprValueT<E> scalar) {
+    return ScalarExpr<E, detail::Scale>(expr.derived(), scalar);
+}
+
+template <typename E>
+ScalarExpr<E, detail::Scale> operator*(detail::ExprValueT<E> scalar, const MatrixExpr<E>& expr) {
+    return ScalarExpr<E, detail::Scale>(expr.derived(), scalar);
+}
+
+template <typename E>
+ScalarExpr<E, detail::Divide> operator/(const MatrixExpr<E>& expr, detail::ExprValueT<E> scalar) {
+    return ScalarExpr<E, detail::Divide>(expr.derived(), scalar);
+}
+
+template <typename E>
+ScalarExpr<E, detail::Scale> operator-(const MatrixExpr<E>& expr) {
+    return ScalarExpr<E, detail::Scale>(expr.derived(), detail::ExprValueT<E>(-1));
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
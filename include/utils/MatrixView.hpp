@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "Matrix.hpp"
+#include "Span.hpp"
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Non-owning, read-only view of a rectangular block or row subset of a matrix
+ *
+ * A view is a base pointer, a row stride, a column offset and an optional
+ * list of row indices (a gather). Train/test splits, folds and tree
+ * partitions are expressed as views over one shared buffer instead of
+ * copies. The viewed storage must outlive the view; the index list is
+ * shared and owned by the views that use it.
+ *
+ * @tparam T Element type (use the MatrixView and MatrixViewF aliases)
+ */
+template <typename T>
+class BasicMatrixView {
+public:
+    using value_type = T;
+
+    BasicMatrixView();
+
+    /**
+     * @brief View an entire matrix
+     * @param matrix Matrix to view
+     */
+    BasicMatrixView(const BasicMatrix<T>& matrix);
+
+    /**
+     * @brief View a raw row-major block
+     * @param data Pointer to the first element
+     * @param rows Number of rows
+     * @param cols Number of columns
+     * @param stride Distance between consecutive rows
+     */
+    BasicMatrixView(const T* data, size_t rows, size_t cols, size_t stride);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t stride() const { return stride_; }
+
+    /**
+     * @brief Whether rows are evenly strided (no index list)
+     */
+    bool isStrided() const { return !indices_; }
+
+    /**
+     * @brief Unchecked pointer to the first element of a row
+     * @param row Row index within the view
+     */
+    const T* rowPtr(size_t row) const {
+        return data_ + (indices_ ? (*indices_)[row] : row) * stride_;
+    }
+
+    /**
+     * @brief Unchecked element access
+     */
+    T operator()(size_t row, size_t col) const { return rowPtr(row)[col]; }
+
+    /**
+     * @brief Bounds-checked row access
+     * @param row Row index within the view
+     * @return Span over the row's elements
+     */
+    Span<const T> operator[](size_t row) const;
+
+    /**
+     * @brief View of a contiguous block of rows and columns
+     * @param rowBegin First row
+     * @param rowCount Number of rows
+     * @param colBegin First column
+     * @param colCount Number of columns
+     */
+    BasicMatrixView block(size_t rowBegin, size_t rowCount,
+                     size_t colBegin, size_t colCount) const;
+
+    /**
+     * @brief View of the given rows, in the given order (indices are relative to this view)
+     * @param rowIndices Rows to select
+     */
+    BasicMatrixView selectRows(std::vector<size_t> rowIndices) const;
+
+    /**
+     * @brief Copy the viewed elements into a dense matrix
+     * @tparam U Element type of the result (defaults to T)
+     */
+    template <typename U = T>
+    BasicMatrix<U> toMatrix() const;
+
+private:
+    const T* data_;
+    size_t rows_;
+    size_t cols_;
+    size_t stride_;
+    std::shared_ptr<const std::vector<size_t>> indices_;
+};
+
+using MatrixView = BasicMatrixView<double>;
+using MatrixViewF = BasicMatrixView<float>;
+
+template <typename T>
+template <typename U>
+BasicMatrix<U> BasicMatrixView<T>::toMatrix() const {
+    BasicMatrix<U> result(rows_, cols_);
+    for (size_t i = 0; i < rows_; ++i) {
+        const T* row = rowPtr(i);
+        std::copy(row, row + cols_, result.rowPtr(i));
+    }
+    return result;
+}
+
+extern template class BasicMatrixView<float>;
+extern template class BasicMatrixView<double>;
+
+/**
+ * @brief Copy the elements of a vector at the given positions
+ * @param values Source values
+ * @param indices Positions to take
+ * @return Gathered values
+ */
+std::vector<double> gather(const std::vector<double>& values, const std::vector<size_t>& indices);
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
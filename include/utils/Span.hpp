@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Non-owning view over a contiguous run of elements
+ *
+ * A minimal stand-in for std::span: a pointer and a length, cheap to copy and
+ * pass by value. Element access is unchecked.
+ *
+ * @tparam T Element type (const-qualify for read-only views)
+ */
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    constexpr Span() noexcept : data_(nullptr), size_(0) {}
+    constexpr Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+    /**
+     * @brief View a std::vector's contents
+     * @param vec Vector to view (must outlive the span)
+     */
+    template <typename Alloc>
+    Span(std::vector<value_type, Alloc>& vec) noexcept
+        : data_(vec.data()), size_(vec.size()) {}
+
+    template <typename Alloc, typename U = T,
+              typename = std::enable_if_t<std::is_const<U>::value>>
+    Span(const std::vector<value_type, Alloc>& vec) noexcept
+        : data_(vec.data()), size_(vec.size()) {}
+
+    /**
+     * @brief Allow implicit conversion from Span<T> to Span<const T>
+     */
+    template <typename U,
+              typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) noexcept
+        : data_(other.data()), size_(other.size()) {}
+
+    constexpr T& operator[](size_t index) const noexcept { return data_[index]; }
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    /**
+     * @brief Sub-view of this span
+     * @param offset First element of the sub-view
+     * @param count Number of elements
+     */
+    constexpr Span subspan(size_t offset, size_t count) const noexcept {
+        return Span(data_ + offset, count);
+    }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
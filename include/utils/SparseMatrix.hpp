@@ -0,0 +1,199 @@
+#pragma once
+
+#include <vector>
+#include "Matrix.hpp"
+#include "MatrixView.hpp"
+#include "Span.hpp"
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Compressed sparse matrix in CSR or CSC layout
+ *
+ * Nonzeros are stored as three arrays: outer offsets (one per row for CSR,
+ * one per column for CSC, plus a terminator), inner indices sorted within
+ * each outer slice, and values. A CSR matrix and the CSC matrix of its
+ * transpose share the same arrays, so transpose() only relabels them;
+ * toCSR()/toCSC() change the physical layout with a counting sort.
+ */
+class SparseMatrix {
+public:
+    enum class Layout {
+        CSR,
+        CSC
+    };
+
+    /**
+     * @brief One (row, col, value) entry used to build a matrix
+     */
+    struct Triplet {
+        size_t row;
+        size_t col;
+        double value;
+    };
+
+    SparseMatrix();
+
+    /**
+     * @brief Create an empty (all-zero) matrix
+     * @param rows Number of rows
+     * @param cols Number of columns
+     * @param layout Storage layout
+     */
+    SparseMatrix(size_t rows, size_t cols, Layout layout = Layout::CSR);
+
+    /**
+     * @brief Adopt compressed arrays
+     * @param rows Number of rows
+     * @param cols Number of columns
+     * @param offsets Outer offsets (rows + 1 for CSR, cols + 1 for CSC)
+     * @param indices Inner indices, sorted and unique within each outer slice
+     * @param values Nonzero values
+     * @param layout Layout the arrays are in
+     */
+    SparseMatrix(size_t rows, size_t cols,
+                 std::vector<size_t> offsets,
+                 std::vector<size_t> indices,
+                 std::vector<double> values,
+                 Layout layout = Layout::CSR);
+
+    /**
+     * @brief Build a CSR matrix from unordered triplets; duplicates are summed
+     * @param rows Number of rows
+     * @param cols Number of columns
+     * @param triplets Nonzero entries
+     * @return CSR matrix
+     */
+    static SparseMatrix fromTriplets(size_t rows, size_t cols,
+                                     const std::vector<Triplet>& triplets);
+
+    /**
+     * @brief Compress a dense matrix, dropping entries with |x| <= tolerance
+     * @param dense Dense input
+     * @param tolerance Magnitude at or below which entries count as zero
+     * @return CSR matrix
+     */
+    static SparseMatrix fromDense(const MatrixView& dense, double tolerance = 0.0);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t nonZeros() const { return values_.size(); }
+    Layout layout() const { return layout_; }
+
+    /**
+     * @brief Fraction of entries that are stored
+     */
+    double density() const;
+
+    /**
+     * @brief Number of outer slices (rows for CSR, columns for CSC)
+     */
+    size_t outerSize() const { return layout_ == Layout::CSR ? rows_ : cols_; }
+
+    const std::vector<size_t>& offsets() const { return offsets_; }
+    const std::vector<size_t>& indices() const { return indices_; }
+    const std::vector<double>& values() const { return values_; }
+
+    /**
+     * @brief Inner indices of one outer slice (a row for CSR, a column for CSC)
+     */
+    Span<const size_t> innerIndices(size_t outer) const {
+        return Span<const size_t>(indices_.data() + offsets_[outer],
+                                  offsets_[outer + 1] - offsets_[outer]);
+    }
+
+    /**
+     * @brief Values of one outer slice
+     */
+    Span<const double> innerValues(size_t outer) const {
+        return Span<const double>(values_.data() + offsets_[outer],
+                                  offsets_[outer + 1] - offsets_[outer]);
+    }
+
+    /**
+     * @brief Element lookup by binary search within the outer slice
+     */
+    double operator()(size_t row, size_t col) const;
+
+    /**
+     * @brief Transpose in O(1) reordering work: the arrays are copied as-is
+     *        and relabelled from CSR to CSC or back
+     */
+    SparseMatrix transpose() const;
+
+    /**
+     * @brief Same matrix in CSR layout
+     */
+    SparseMatrix toCSR() const;
+
+    /**
+     * @brief Same matrix in CSC layout
+     */
+    SparseMatrix toCSC() const;
+
+    /**
+     * @brief Expand to a dense matrix
+     */
+    Matrix toDense() const;
+
+    /**
+     * @brief Sparse matrix-vector product y = A * x
+     * @param x Dense vector of length cols()
+     * @return Dense vector of length rows()
+     */
+    std::vector<double> multiply(Span<const double> x) const;
+
+    /**
+     * @brief Sparse matrix-vector product into a caller-owned buffer
+     * @param x Dense vector of length cols()
+     * @param y Output of length rows(); overwritten
+     */
+    void multiply(Span<const double> x, Span<double> y) const;
+
+    /**
+     * @brief Sparse-dense product C = A * B
+     * @param B Dense matrix with cols() rows
+     * @return Dense rows() x B.cols() matrix
+     */
+    Matrix multiply(const MatrixView& B) const;
+
+    /**
+     * @brief Dense Gram matrix A^T * A
+     *
+     * Accumulates the outer product of each row's nonzeros, so the cost is
+     * the sum of squared row lengths rather than rows * cols^2.
+     *
+     * @return Dense cols() x cols() matrix
+     */
+    Matrix gram() const;
+
+    /**
+     * @brief Squared Euclidean norm of every row
+     */
+    std::vector<double> rowSquaredNorms() const;
+
+    Matrix operator*(const Matrix& other) const { return multiply(other); }
+
+private:
+    size_t rows_;
+    size_t cols_;
+    Layout layout_;
+    std::vector<size_t> offsets_;
+    std::vector<size_t> indices_;
+    std::vector<double> values_;
+
+    /**
+     * @brief Reorder the arrays so the other dimension becomes the outer one
+     */
+    SparseMatrix switchLayout() const;
+};
+
+/**
+ * @brief Dot product of two sorted sparse vectors
+ */
+double sparseDot(Span<const size_t> aIndices, Span<const double> aValues,
+                 Span<const size_t> bIndices, Span<const double> bValues);
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "FunctionRef.hpp"
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Process-wide worker pool backing the library's parallel loops
+ *
+ * Work is split into contiguous chunks whose boundaries depend only on the
+ * range, the grain size and the thread count, so repeated runs with the same
+ * settings partition identically. Calls made from inside a worker run
+ * serially rather than re-entering the pool. Loop bodies are passed by
+ * reference and the task list keeps its capacity, so a warm pool runs a
+ * loop without touching the heap.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Shared pool used by Matrix, gemm and the models
+     *
+     * Sized from the ML_NUM_THREADS environment variable when set, otherwise
+     * from std::thread::hardware_concurrency().
+     */
+    static ThreadPool& instance();
+
+    explicit ThreadPool(size_t numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Resize the pool (joins and respawns workers)
+     *
+     * Must not be called while a parallel loop is in flight.
+     * @param numThreads Total threads including the caller; 0 means ML_NUM_THREADS if set, else hardware concurrency
+     */
+    void setNumThreads(size_t numThreads);
+
+    /**
+     * @brief Total threads available to a parallel loop, including the caller
+     */
+    size_t numThreads() const { return workers_.size() + 1; }
+
+    /**
+     * @brief Run fn(lo, hi) over [begin, end) split into contiguous chunks
+     * @param begin First index
+     * @param end One past the last index
+     * @param grain Minimum indices per chunk
+     * @param fn Callable invoked once per chunk; exceptions propagate to the caller
+     */
+    void parallelFor(size_t begin, size_t end, size_t grain, FunctionRef<void(size_t, size_t)> fn);
+
+    /**
+     * @brief Number of chunks parallelFor would use for a range
+     * @param count Number of indices
+     * @param grain Minimum indices per chunk
+     */
+    size_t chunkCount(size_t count, size_t grain) const;
+
+private:
+    // One chunk of a parallelFor call; run points into the caller's frame,
+    // which outlives the task because the caller waits for every chunk
+    struct Task {
+        FunctionRef<void(size_t)> run;
+        size_t chunk;
+    };
+
+    std::vector<std::thread> workers_;
+    // Pending tasks are [nextTask_, tasks_.size()); cleared, not freed, once drained
+    std::vector<Task> tasks_;
+    size_t nextTask_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_;
+
+    void start(size_t numThreads);
+    void stop();
+    void workerLoop();
+};
+
+/**
+ * @brief RAII cap on the threads used by parallel loops on this thread
+ *
+ * Lets a caller that already parallelizes at an outer level pin library
+ * calls to a fixed thread count (1 for fully serial) within a scope.
+ */
+class ThreadLimit {
+public:
+    explicit ThreadLimit(size_t maxThreads);
+    ~ThreadLimit();
+
+    ThreadLimit(const ThreadLimit&) = delete;
+    ThreadLimit& operator=(const ThreadLimit&) = delete;
+
+    /**
+     * @brief Current cap for the calling thread (0 when uncapped)
+     */
+    static size_t current();
+
+private:
+    size_t previous_;
+};
+
+/**
+ * @brief Convenience wrapper around ThreadPool::instance().parallelFor
+ */
+inline void parallelFor(size_t begin, size_t end, size_t grain,
+                        FunctionRef<void(size_t, size_t)> fn) {
+    ThreadPool::instance().parallelFor(begin, end, grain, fn);
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
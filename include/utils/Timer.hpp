@@ -0,0 +1,16 @@
+#pragma once
+
+#include <chrono>
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Wall-clock seconds elapsed since a steady-clock time point
+ */
+inline double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace ml {
+namespace utils {
+
+/**
+ * @brief Recycling pool for Matrix buffers
+ *
+ * While a WorkspaceScope is active on a thread, every cache-line aligned
+ * buffer that thread frees is parked in the workspace, keyed by its byte
+ * size, instead of being returned to the heap; a later request for the same
+ * size takes it back. Training loops that build and drop same-shaped
+ * temporaries therefore stop touching the heap after their first iteration.
+ *
+ * Cached blocks are ordinary aligned operator new allocations, so a Matrix
+ * that escapes the scope can still be freed anywhere. A workspace belongs to
+ * one thread at a time; worker threads keep using the heap directly.
+ */
+class Workspace {
+public:
+    /**
+     * @brief Allocation counters since construction or the last resetStats()
+     */
+    struct Stats {
+        size_t reused = 0;         ///< Requests served from the cache (heap allocations avoided)
+        size_t heapAllocations = 0;///< Requests that fell through to operator new
+        size_t cachedBlocks = 0;   ///< Blocks currently parked in the cache
+        size_t cachedBytes = 0;    ///< Bytes currently parked in the cache
+    };
+
+    /**
+     * @brief Alignment of the buffers the workspace recycles
+     */
+    static constexpr size_t kAlignment = 64;
+
+    /**
+     * @brief Create an empty workspace
+     * @param maxCachedBytes Freed blocks beyond this total go back to the heap
+     */
+    explicit Workspace(size_t maxCachedBytes = size_t(256) << 20);
+    ~Workspace();
+
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    /**
+     * @brief Workspace active on the calling thread, or nullptr
+     */
+    static Workspace* current();
+
+    /**
+     * @brief Allocate an aligned block, reusing a cached one of the same size
+     * @param bytes Block size in bytes
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * @brief Park a block for reuse, or free it when the cache is full
+     * @param ptr Block from aligned operator new
+     * @param bytes Block size in bytes
+     */
+    void deallocate(void* ptr, size_t bytes) noexcept;
+
+    /**
+     * @brief Return every cached block to the heap
+     */
+    void release();
+
+    const Stats& stats() const { return stats_; }
+    void resetStats();
+
+private:
+    size_t maxCachedBytes_;
+    std::unordered_map<size_t, std::vector<void*>> cache_;
+    Stats stats_;
+};
+
+/**
+ * @brief RAII guard making a workspace current for the calling thread
+ *
+ * Scopes nest; the previous workspace is restored on destruction. The
+ * workspace keeps its cache when the scope ends, so one workspace reused
+ * across epochs or folds only warms up once.
+ */
+class WorkspaceScope {
+public:
+    explicit WorkspaceScope(Workspace& workspace);
+    ~WorkspaceScope();
+
+    WorkspaceScope(const WorkspaceScope&) = delete;
+    WorkspaceScope& operator=(const WorkspaceScope&) = delete;
+
+private:
+    Workspace* previous_;
+};
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "../../include/data/BatchSource.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ml {
+namespace data {
+
+ViewBatchSource::ViewBatchSource(const utils::MatrixView& features,
+                                 const std::vector<double>& targets,
+                                 size_t batchSize)
+    : features_(features), targets_(targets), batchSize_(batchSize) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
+    if (batchSize_ == 0) {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+}
+
+bool ViewBatchSource::next(Batch& batch) {
+    const size_t rows = std::min(batchSize_, features_.rows() - position_);
+    if (rows == 0) {
+        batch.features = utils::Matrix();
+        batch.targets.clear();
+        return false;
+    }
+
+    if (batch.features.rows() != rows || batch.features.cols() != features_.cols()) {
+        batch.features = utils::Matrix(rows, features_.cols());
+    }
+    batch.targets.resize(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        const double* row = features_.rowPtr(position_ + i);
+        std::copy(row, row + features_.cols(), batch.features.rowPtr(i));
+        batch.targets[i] = targets_[position_ + i];
+    }
+
+    position_ += rows;
+    return true;
+}
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "../../include/data/CSVBatchReader.hpp"
+#include "../../include/data/CSVParser.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ml {
+namespace data {
+
+CSVBatchReader::CSVBatchReader(const std::string& filepath, size_t batchSize,
+                               bool hasHeader, char delimiter)
+    : filepath_(filepath), file_(filepath, std::ios::binary), batchSize_(batchSize),
+      hasHeader_(hasHeader), delimiter_(delimiter) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filepath);
+    }
+    if (batchSize_ == 0) {
+        throw std::invalid_argument("Batch size must be positive");
+    }
+    rewind();
+}
+
+void CSVBatchReader::reset() {
+    rewind();
+}
+
+void CSVBatchReader::rewind() {
+    file_.clear();
+    file_.seekg(0);
+    rowsRead_ = 0;
+    pendingLine_ = false;
+
+    if (hasHeader_ && std::getline(file_, line_)) {
+        featureNames_.clear();
+        csv::forEachField(line_.data(), line_.data() + line_.size(), delimiter_,
+                          [&](const char* first, const char* last) {
+                              featureNames_.emplace_back(first, last);
+                          });
+        // Remove the target column name
+        if (!featureNames_.empty()) {
+            featureNames_.pop_back();
+        }
+    }
+
+    // The first data row fixes the column count; keep it for the first batch
+    if (readDataLine()) {
+        cols_ = csv::countFields(line_.data(), line_.data() + line_.size(), delimiter_) - 1;
+        pendingLine_ = true;
+    }
+}
+
+bool CSVBatchReader::readDataLine() {
+    while (std::getline(file_, line_)) {
+        if (csv::countFields(line_.data(), line_.data() + line_.size(), delimiter_) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CSVBatchReader::next(Batch& batch) {
+    if (batch.features.rows() != batchSize_ || batch.features.cols() != cols_) {
+        batch.features = utils::Matrix(batchSize_, cols_);
+    }
+    batch.targets.resize(batchSize_);
+
+    size_t rows = 0;
+    while (rows < batchSize_) {
+        if (pendingLine_) {
+            pendingLine_ = false;
+        } else if (!readDataLine()) {
+            break;
+        }
+
+        const char* line = line_.data();
+        const char* lineEnd = line + line_.size();
+        double* out = batch.features.rowPtr(rows);
+        size_t field = 0;
+        csv::forEachField(line, lineEnd, delimiter_, [&](const char* first, const char* last) {
+            if (field < cols_) {
+                out[field] = csv::parseNumber<double>(first, last, line, lineEnd);
+            } else if (field == cols_) {
+                // Last column is the target
+                batch.targets[rows] = csv::parseNumber<double>(first, last, line, lineEnd);
+            } else {
+                csv::throwParseError(line, lineEnd, "Inconsistent row sizes in input data");
+            }
+            ++field;
+        });
+        if (field != cols_ + 1) {
+            csv::throwParseError(line, lineEnd, "Inconsistent row sizes in input data");
+        }
+        ++rows;
+    }
+
+    rowsRead_ += rows;
+    batch.targets.resize(rows);
+    if (rows == 0) {
+        batch.features = utils::Matrix();
+        return false;
+    }
+    if (rows < batchSize_) {
+        // Short final batch: shrink to the rows actually read
+        utils::Matrix last(rows, cols_);
+        for (size_t i = 0; i < rows; ++i) {
+            std::copy(batch.features.rowPtr(i), batch.features.rowPtr(i) + cols_, last.rowPtr(i));
+        }
+        batch.features = std::move(last);
+    }
+    return true;
+}
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
@@ -1,63 +1,422 @@
 #include "../../include/data/DataLoader.hpp"
-#include <fstream>
+#include "../../include/data/CSVParser.hpp"
+#include "../../include/data/BinaryFormat.hpp"
+#include "../../include/utils/MappedFile.hpp"
+#include "../../include/utils/ThreadPool.hpp"
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
 
 namespace ml {
 namespace data {
 
-bool DataLoader::loadFromCSV(const std::string& filepath, bool hasHeader, char delimiter) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filepath);
+namespace {
+
+// Chunks below this size are not worth a task of their own
+constexpr size_t kMinChunkBytes = size_t(1) << 20;
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t firstRow;
+    size_t rows;
+};
+
+/**
+ * @brief Split [begin, end) into newline-aligned chunks
+ */
+std::vector<Chunk> splitChunks(const char* begin, const char* end, size_t maxChunks) {
+    const size_t bytes = static_cast<size_t>(end - begin);
+    size_t count = std::max<size_t>(1, std::min(maxChunks, (bytes + kMinChunkBytes - 1) / kMinChunkBytes));
+
+    std::vector<Chunk> chunks;
+    const char* chunkBegin = begin;
+    for (size_t c = 1; c <= count && chunkBegin < end; ++c) {
+        const char* chunkEnd = end;
+        if (c < count) {
+            chunkEnd = std::max(chunkBegin, begin + bytes * c / count);
+            const char* newline = static_cast<const char*>(
+                std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        chunks.push_back({chunkBegin, chunkEnd, 0, 0});
+        chunkBegin = chunkEnd;
+    }
+    return chunks;
+}
+
+/**
+ * @brief Parse every chunk straight into its rows of features and targets
+ */
+template <typename T>
+void parseChunks(const std::vector<Chunk>& chunks, char delimiter,
+                 utils::BasicMatrix<T>& features, std::vector<double>& targets) {
+    const size_t cols = features.cols();
+    utils::parallelFor(0, chunks.size(), 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            size_t row = chunks[c].firstRow;
+            csv::forEachLine(chunks[c].begin, chunks[c].end, [&](const char* line, const char* lineEnd) {
+                T* out = features.rowPtr(row);
+                size_t field = 0;
+                csv::forEachField(line, lineEnd, delimiter, [&](const char* first, const char* last) {
+                    if (field < cols) {
+                        out[field] = csv::parseNumber<T>(first, last, line, lineEnd);
+                    } else if (field == cols) {
+                        // Last column is the target
+                        targets[row] = csv::parseNumber<double>(first, last, line, lineEnd);
+                    } else {
+                        csv::throwParseError(line, lineEnd, "Inconsistent row sizes in input data");
+                    }
+                    ++field;
+                });
+                if (field == 0) {
+                    return;
+                }
+                if (field != cols + 1) {
+                    csv::throwParseError(line, lineEnd, "Inconsistent row sizes in input data");
+                }
+                ++row;
+            });
+        }
+    });
+}
+
+/**
+ * @brief Sequential writer for the binary dataset format
+ *
+ * The header is written last, once the row count is known, so features can
+ * be streamed in without knowing the size up front.
+ */
+class BinaryWriter {
+public:
+    BinaryWriter(const std::string& filepath, const std::vector<std::string>& names,
+                 size_t cols, Precision precision)
+        : out_(filepath, std::ios::binary | std::ios::trunc), filepath_(filepath) {
+        if (!out_.is_open()) {
+            throw std::runtime_error("Cannot open file: " + filepath);
+        }
+
+        std::memset(&header_, 0, sizeof(header_));
+        std::memcpy(header_.magic, binary::kMagic, sizeof(header_.magic));
+        header_.version = binary::kVersion;
+        header_.byteOrder = binary::kByteOrder;
+        header_.elementType = static_cast<uint32_t>(precision == Precision::Float32
+                                                        ? binary::ElementType::Float32
+                                                        : binary::ElementType::Float64);
+        header_.cols = cols;
+
+        // Placeholder header, rewritten by finish()
+        padTo(binary::kBlockAlignment);
+        header_.namesOffset = position_;
+        for (size_t j = 0; j < cols; ++j) {
+            const std::string& name = j < names.size() ? names[j] : std::string();
+            uint32_t length = static_cast<uint32_t>(name.size());
+            write(&length, sizeof(length));
+            write(name.data(), name.size());
+        }
+
+        padTo(binary::alignOffset(position_));
+        header_.featuresOffset = position_;
+    }
+
+    /**
+     * @brief Append rows of features, converted to the file's element type
+     */
+    template <typename T>
+    void appendRows(const utils::BasicMatrixView<T>& rows) {
+        if (header_.elementType == static_cast<uint32_t>(binary::ElementType::Float32)) {
+            appendAs<float>(rows);
+        } else {
+            appendAs<double>(rows);
+        }
+        header_.rows += rows.rows();
+    }
+
+    void finish(const std::vector<double>& targets) {
+        if (targets.size() != header_.rows) {
+            throw std::invalid_argument("Number of samples in features and targets must match");
+        }
+        padTo(binary::alignOffset(position_));
+        header_.targetsOffset = position_;
+        write(targets.data(), targets.size() * sizeof(double));
+
+        out_.seekp(0);
+        out_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+        out_.flush();
+        if (!out_) {
+            throw std::runtime_error("Error writing file: " + filepath_);
+        }
+    }
+
+private:
+    std::ofstream out_;
+    std::string filepath_;
+    binary::Header header_;
+    uint64_t position_ = 0;
+    std::vector<char> scratch_;
+
+    void write(const void* data, size_t bytes) {
+        out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        position_ += bytes;
+    }
+
+    void padTo(uint64_t offset) {
+        static const char zeros[binary::kBlockAlignment] = {};
+        write(zeros, offset - position_);
+    }
+
+    template <typename U, typename T>
+    void appendAs(const utils::BasicMatrixView<T>& rows) {
+        const size_t cols = rows.cols();
+        for (size_t i = 0; i < rows.rows(); ++i) {
+            const T* row = rows.rowPtr(i);
+            if constexpr (std::is_same<T, U>::value) {
+                write(row, cols * sizeof(U));
+            } else {
+                scratch_.resize(cols * sizeof(U));
+                U* converted = reinterpret_cast<U*>(scratch_.data());
+                std::copy(row, row + cols, converted);
+                write(converted, cols * sizeof(U));
+            }
+        }
     }
+};
 
-    std::string line;
-    std::vector<std::vector<double>> featuresData;
+} // namespace
+
+bool DataLoader::loadFromCSV(const std::string& filepath, bool hasHeader, char delimiter,
+                             Precision precision) {
+    const auto start = std::chrono::steady_clock::now();
+    utils::MappedFile file(filepath);
+
+    unmap();
     targets_.clear();
     featureNames_.clear();
 
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
     // Handle header if present
-    if (hasHeader && std::getline(file, line)) {
-        featureNames_ = parseLine(line, delimiter);
+    if (hasHeader && begin < end) {
+        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        const char* headerEnd = newline ? newline : end;
+        featureNames_ = parseLine(std::string(begin, headerEnd), delimiter);
         // Remove the target column name
-        featureNames_.pop_back();
+        if (!featureNames_.empty()) {
+            featureNames_.pop_back();
+        }
+        begin = newline ? newline + 1 : end;
     }
 
-    // Read data
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
+    // The first data row fixes the column count
+    size_t fields = 0;
+    for (const char* line = begin; line < end && fields == 0;) {
+        const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        const char* lineEnd = newline ? newline : end;
+        fields = csv::countFields(line, lineEnd, delimiter);
+        line = newline ? newline + 1 : end;
+    }
+    if (fields == 0) {
+        return false;
+    }
+    const size_t cols = fields - 1;
 
-        auto tokens = parseLine(line, delimiter);
-        if (tokens.empty()) continue;
+    // Pass 1: count the data rows of every chunk to place it in the output
+    std::vector<Chunk> chunks = splitChunks(begin, end, utils::ThreadPool::instance().numThreads() * 4);
+    utils::parallelFor(0, chunks.size(), 1, [&](size_t lo, size_t hi) {
+        for (size_t c = lo; c < hi; ++c) {
+            csv::forEachLine(chunks[c].begin, chunks[c].end, [&](const char* line, const char* lineEnd) {
+                if (csv::countFields(line, lineEnd, delimiter) > 0) {
+                    ++chunks[c].rows;
+                }
+            });
+        }
+    });
 
-        // Last column is the target
-        try {
-            targets_.push_back(std::stod(tokens.back()));
-            tokens.pop_back();
+    size_t rows = 0;
+    for (Chunk& chunk : chunks) {
+        chunk.firstRow = rows;
+        rows += chunk.rows;
+    }
 
-            std::vector<double> featureRow;
-            featureRow.reserve(tokens.size());
-            
-            for (const auto& token : tokens) {
-                featureRow.push_back(std::stod(token));
-            }
-            
-            featuresData.push_back(std::move(featureRow));
-        } catch (const std::exception& e) {
-            throw std::runtime_error("Error parsing line: " + line + "\nError: " + e.what());
+    // Pass 2: parse in place into the final buffers
+    targets_.resize(rows);
+    precision_ = precision;
+    if (precision == Precision::Float32) {
+        featuresF_ = utils::MatrixF(rows, cols);
+        parseChunks(chunks, delimiter, featuresF_, targets_);
+        features_ = utils::Matrix();
+    } else {
+        features_ = utils::Matrix(rows, cols);
+        parseChunks(chunks, delimiter, features_, targets_);
+        featuresF_ = utils::MatrixF();
+    }
+
+    stats_.bytes = file.size();
+    stats_.rows = rows;
+    stats_.chunks = chunks.size();
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return true;
+}
+
+bool DataLoader::loadFromBinary(const std::string& filepath) {
+    const auto start = std::chrono::steady_clock::now();
+    utils::MappedFile file(filepath);
+
+    binary::Header header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error("Not a binary dataset: " + filepath);
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, binary::kMagic, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Not a binary dataset: " + filepath);
+    }
+    if (header.byteOrder != binary::kByteOrder) {
+        throw std::runtime_error("Binary dataset has foreign byte order: " + filepath);
+    }
+    if (header.version != binary::kVersion) {
+        throw std::runtime_error("Unsupported binary dataset version " +
+                                 std::to_string(header.version) + ": " + filepath);
+    }
+
+    const bool isFloat = header.elementType == static_cast<uint32_t>(binary::ElementType::Float32);
+    if (!isFloat && header.elementType != static_cast<uint32_t>(binary::ElementType::Float64)) {
+        throw std::runtime_error("Unknown element type in binary dataset: " + filepath);
+    }
+    // Sections are checked against the space left after their offset by
+    // division, so corrupt counts cannot overflow a byte-count product
+    const uint64_t elementSize = isFloat ? sizeof(float) : sizeof(double);
+    const uint64_t size = file.size();
+    if (header.featuresOffset % binary::kBlockAlignment != 0 ||
+        header.namesOffset > header.featuresOffset || header.featuresOffset > size ||
+        header.targetsOffset > size ||
+        header.cols > (header.featuresOffset - header.namesOffset) / sizeof(uint32_t) ||
+        (header.cols > 0 &&
+         header.rows > (size - header.featuresOffset) / elementSize / header.cols) ||
+        header.rows > (size - header.targetsOffset) / sizeof(double)) {
+        throw std::runtime_error("Truncated or corrupt binary dataset: " + filepath);
+    }
+
+    // Feature names: cols entries of (uint32 length, bytes)
+    std::vector<std::string> names;
+    names.reserve(header.cols);
+    uint64_t offset = header.namesOffset;
+    for (uint64_t j = 0; j < header.cols; ++j) {
+        uint32_t length = 0;
+        if (header.featuresOffset - offset < sizeof(length)) {
+            throw std::runtime_error("Truncated or corrupt binary dataset: " + filepath);
+        }
+        std::memcpy(&length, file.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (length > header.featuresOffset - offset) {
+            throw std::runtime_error("Truncated or corrupt binary dataset: " + filepath);
         }
+        names.emplace_back(file.data() + offset, length);
+        offset += length;
     }
+    bool anyNamed = std::any_of(names.begin(), names.end(),
+                                [](const std::string& name) { return !name.empty(); });
 
-    if (featuresData.empty()) {
-        return false;
+    unmap();
+    features_ = utils::Matrix();
+    featuresF_ = utils::MatrixF();
+    featureNames_ = anyNamed ? std::move(names) : std::vector<std::string>();
+
+    // Copied rather than viewed in place: nothing aligns the targets section
+    targets_.resize(header.rows);
+    std::memcpy(targets_.data(), file.data() + header.targetsOffset, header.rows * sizeof(double));
+
+    mapped_ = std::move(file);
+    const char* features = mapped_.data() + header.featuresOffset;
+    if (isFloat) {
+        precision_ = Precision::Float32;
+        mappedFeaturesF_ = utils::MatrixViewF(reinterpret_cast<const float*>(features),
+                                              header.rows, header.cols, header.cols);
+    } else {
+        precision_ = Precision::Float64;
+        mappedFeatures_ = utils::MatrixView(reinterpret_cast<const double*>(features),
+                                            header.rows, header.cols, header.cols);
     }
 
-    // Convert to Matrix
-    features_ = utils::Matrix(featuresData);
-    
-    return true;
+    stats_.bytes = mapped_.size();
+    stats_.rows = header.rows;
+    stats_.chunks = 0;
+    stats_.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return header.rows > 0;
+}
+
+void DataLoader::saveBinary(const std::string& filepath) const {
+    if (precision_ == Precision::Float32) {
+        utils::MatrixViewF features = getFeaturesViewF();
+        BinaryWriter writer(filepath, featureNames_, features.cols(), precision_);
+        writer.appendRows(features);
+        writer.finish(targets_);
+    } else {
+        utils::MatrixView features = getFeaturesView();
+        BinaryWriter writer(filepath, featureNames_, features.cols(), precision_);
+        writer.appendRows(features);
+        writer.finish(targets_);
+    }
+}
+
+size_t DataLoader::convertCSVToBinary(const std::string& csvPath,
+                                      const std::string& binaryPath,
+                                      bool hasHeader, char delimiter,
+                                      Precision precision) {
+    // Large enough to amortize the write calls, small enough to stay in cache
+    constexpr size_t kBatchRows = 8192;
+
+    CSVBatchReader reader(csvPath, kBatchRows, hasHeader, delimiter);
+    BinaryWriter writer(binaryPath, reader.getFeatureNames(), reader.cols(), precision);
+
+    Batch batch;
+    std::vector<double> targets;
+    while (reader.next(batch)) {
+        writer.appendRows(utils::MatrixView(batch.features));
+        targets.insert(targets.end(), batch.targets.begin(), batch.targets.end());
+    }
+    writer.finish(targets);
+
+    return targets.size();
+}
+
+const utils::Matrix& DataLoader::getFeatures() const {
+    if (features_.rows() == 0 && mappedFeatures_.rows() > 0) {
+        features_ = mappedFeatures_.toMatrix();
+    }
+    return features_;
+}
+
+const utils::MatrixF& DataLoader::getFeaturesF() const {
+    if (featuresF_.rows() == 0 && mappedFeaturesF_.rows() > 0) {
+        featuresF_ = mappedFeaturesF_.toMatrix();
+    }
+    return featuresF_;
+}
+
+utils::MatrixView DataLoader::getFeaturesView() const {
+    return mapped_.empty() ? utils::MatrixView(features_) : mappedFeatures_;
+}
+
+utils::MatrixViewF DataLoader::getFeaturesViewF() const {
+    return mapped_.empty() ? utils::MatrixViewF(featuresF_) : mappedFeaturesF_;
+}
+
+void DataLoader::unmap() {
+    mapped_ = utils::MappedFile();
+    mappedFeatures_ = utils::MatrixView();
+    mappedFeaturesF_ = utils::MatrixViewF();
+}
+
+CSVBatchReader DataLoader::streamCSV(const std::string& filepath, size_t batchSize,
+                                    bool hasHeader, char delimiter) {
+    return CSVBatchReader(filepath, batchSize, hasHeader, delimiter);
 }
 
 std::vector<std::string> DataLoader::parseLine(const std::string& line, char delimiter) const {
@@ -79,6 +438,4 @@ std::vector<std::string> DataLoader::parseLine(const std::string& line, char del
 }
 
 } // namespace data
-} // namespace ml
-
-
+} // namespace ml
\ No newline at end of file
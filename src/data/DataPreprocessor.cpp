@@ -1,18 +1,24 @@
 #include "../../include/data/DataPreprocessor.hpp"
+#include "../../include/data/Scaler.hpp"
 #include <algorithm>
 #include <random>
 #include <stdexcept>
 #include <cmath>
+#include <numeric>
 
 namespace ml {
 namespace data {
 
-std::pair<std::pair<utils::Matrix, std::vector<double>>,
-          std::pair<utils::Matrix, std::vector<double>>>
-DataPreprocessor::trainTestSplit(const utils::Matrix& features,
-                                 const std::vector<double>& targets,
-                                 double trainRatio,
-                                 bool shuffle) {
+namespace {
+
+template <typename T>
+std::pair<std::pair<utils::BasicMatrixView<T>, std::vector<double>>,
+          std::pair<utils::BasicMatrixView<T>, std::vector<double>>>
+trainTestSplitImpl(const utils::BasicMatrixView<T>& features,
+                   const std::vector<double>& targets,
+                   double trainRatio,
+                   bool shuffle,
+                   std::optional<uint64_t> seed) {
     if (features.rows() != targets.size()) {
         throw std::invalid_argument("Number of samples in features and targets must match");
     }
@@ -24,95 +30,78 @@ DataPreprocessor::trainTestSplit(const utils::Matrix& features,
     std::iota(indices.begin(), indices.end(), 0);
 
     if (shuffle) {
-        std::random_device rd;
-        std::mt19937 g(rd());
+        std::mt19937_64 g(seed ? *seed : std::random_device()());
         std::shuffle(indices.begin(), indices.end(), g);
     }
 
-    utils::Matrix trainFeatures(numTrainSamples, features.cols());
-    std::vector<double> trainTargets(numTrainSamples);
-    utils::Matrix testFeatures(numSamples - numTrainSamples, features.cols());
-    std::vector<double> testTargets(numSamples - numTrainSamples);
+    std::vector<size_t> trainIndices(indices.begin(), indices.begin() + numTrainSamples);
+    std::vector<size_t> testIndices(indices.begin() + numTrainSamples, indices.end());
 
-    for (size_t i = 0; i < numTrainSamples; ++i) {
-        trainFeatures[i] = features[indices[i]];
-        trainTargets[i] = targets[indices[i]];
-    }
+    std::vector<double> trainTargets = utils::gather(targets, trainIndices);
+    std::vector<double> testTargets = utils::gather(targets, testIndices);
 
-    for (size_t i = numTrainSamples; i < numSamples; ++i) {
-        testFeatures[i - numTrainSamples] = features[indices[i]];
-        testTargets[i - numTrainSamples] = targets[indices[i]];
-    }
-
-    return {{trainFeatures, trainTargets}, {testFeatures, testTargets}};
+    return {{features.selectRows(std::move(trainIndices)), std::move(trainTargets)},
+            {features.selectRows(std::move(testIndices)), std::move(testTargets)}};
 }
 
-utils::Matrix DataPreprocessor::standardize(const utils::Matrix& features) {
-    utils::Matrix standardizedFeatures(features.rows(), features.cols());
-
-    for (size_t j = 0; j < features.cols(); ++j) {
-        double mean = 0.0;
-        double variance = 0.0;
-
-        // Calculate mean
-        for (size_t i = 0; i < features.rows(); ++i) {
-            mean += features[i][j];
-        }
-        mean /= features.rows();
+template <typename T>
+utils::BasicMatrix<T> addBiasImpl(const utils::BasicMatrixView<T>& features) {
+    utils::BasicMatrix<T> biasedFeatures(features.rows(), features.cols() + 1);
 
-        // Calculate variance
-        for (size_t i = 0; i < features.rows(); ++i) {
-            double diff = features[i][j] - mean;
-            variance += diff * diff;
-        }
-        variance /= features.rows();
-
-        double stdDev = std::sqrt(variance);
-
-        // Standardize
-        for (size_t i = 0; i < features.rows(); ++i) {
-            standardizedFeatures[i][j] = (features[i][j] - mean) / stdDev;
+    for (size_t i = 0; i < features.rows(); ++i) {
+        biasedFeatures[i][0] = T(1);  // Bias term
+        for (size_t j = 0; j < features.cols(); ++j) {
+            biasedFeatures[i][j + 1] = features(i, j);
         }
     }
 
-    return standardizedFeatures;
+    return biasedFeatures;
 }
 
-utils::Matrix DataPreprocessor::normalize(const utils::Matrix& features) {
-    utils::Matrix normalizedFeatures(features.rows(), features.cols());
+} // namespace
 
-    for (size_t j = 0; j < features.cols(); ++j) {
-        double minVal = features[0][j];
-        double maxVal = features[0][j];
+std::pair<std::pair<utils::MatrixView, std::vector<double>>,
+          std::pair<utils::MatrixView, std::vector<double>>>
+DataPreprocessor::trainTestSplit(const utils::MatrixView& features,
+                                 const std::vector<double>& targets,
+                                 double trainRatio,
+                                 bool shuffle,
+                                 std::optional<uint64_t> seed) {
+    return trainTestSplitImpl(features, targets, trainRatio, shuffle, seed);
+}
 
-        // Find min and max
-        for (size_t i = 1; i < features.rows(); ++i) {
-            minVal = std::min(minVal, features[i][j]);
-            maxVal = std::max(maxVal, features[i][j]);
-        }
+std::pair<std::pair<utils::MatrixViewF, std::vector<double>>,
+          std::pair<utils::MatrixViewF, std::vector<double>>>
+DataPreprocessor::trainTestSplit(const utils::MatrixViewF& features,
+                                 const std::vector<double>& targets,
+                                 double trainRatio,
+                                 bool shuffle,
+                                 std::optional<uint64_t> seed) {
+    return trainTestSplitImpl(features, targets, trainRatio, shuffle, seed);
+}
 
-        double range = maxVal - minVal;
+utils::Matrix DataPreprocessor::standardize(const utils::MatrixView& features) {
+    return StandardScaler().fitTransform(features);
+}
 
-        // Normalize
-        for (size_t i = 0; i < features.rows(); ++i) {
-            normalizedFeatures[i][j] = (features[i][j] - minVal) / range;
-        }
-    }
+utils::MatrixF DataPreprocessor::standardize(const utils::MatrixViewF& features) {
+    return StandardScaler().fitTransform(features);
+}
 
-    return normalizedFeatures;
+utils::Matrix DataPreprocessor::normalize(const utils::MatrixView& features) {
+    return MinMaxScaler().fitTransform(features);
 }
 
-utils::Matrix DataPreprocessor::addBias(const utils::Matrix& features) {
-    utils::Matrix biasedFeatures(features.rows(), features.cols() + 1);
+utils::MatrixF DataPreprocessor::normalize(const utils::MatrixViewF& features) {
+    return MinMaxScaler().fitTransform(features);
+}
 
-    for (size_t i = 0; i < features.rows(); ++i) {
-        biasedFeatures[i][0] = 1.0;  // Bias term
-        for (size_t j = 0; j < features.cols(); ++j) {
-            biasedFeatures[i][j + 1] = features[i][j];
-        }
-    }
+utils::Matrix DataPreprocessor::addBias(const utils::MatrixView& features) {
+    return addBiasImpl(features);
+}
 
-    return biasedFeatures;
+utils::MatrixF DataPreprocessor::addBias(const utils::MatrixViewF& features) {
+    return addBiasImpl(features);
 }
 
 } // namespace data
@@ -0,0 +1,191 @@
+#include "../../include/data/PrefetchBatchSource.hpp"
+#include "../../include/utils/Timer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace ml {
+namespace data {
+
+namespace {
+
+// Default shuffle buffer, in multiples of the queued rows
+constexpr size_t kShuffleQueues = 4;
+
+} // namespace
+
+PrefetchBatchSource::PrefetchBatchSource(BatchSource& upstream, PrefetchOptions options)
+    : upstream_(upstream), options_(std::move(options)), rng_(options_.seed) {
+    if (options_.depth == 0) {
+        throw std::invalid_argument("Prefetch depth must be positive");
+    }
+    if (options_.shuffle && options_.shuffleRows == 0) {
+        options_.shuffleRows = kShuffleQueues * options_.depth * upstream_.batchSize();
+    }
+    start();
+}
+
+PrefetchBatchSource::~PrefetchBatchSource() {
+    stop();
+}
+
+bool PrefetchBatchSource::next(Batch& batch) {
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !ready_.empty() || finished_; });
+    stats_.consumerWaitSeconds += utils::secondsSince(start);
+
+    if (ready_.empty()) {
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+        batch.features = utils::Matrix();
+        batch.targets.clear();
+        return false;
+    }
+
+    // Hand the caller's previous buffer back to the producer
+    std::swap(batch, ready_.front());
+    free_.push_back(std::move(ready_.front()));
+    ready_.pop_front();
+    ++stats_.batches;
+    lock.unlock();
+    cv_.notify_all();
+    return true;
+}
+
+void PrefetchBatchSource::reset() {
+    stop();
+    upstream_.reset();
+    start();
+}
+
+PrefetchStats PrefetchBatchSource::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void PrefetchBatchSource::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!ready_.empty()) {
+            free_.push_back(std::move(ready_.front()));
+            ready_.pop_front();
+        }
+        finished_ = false;
+        stopping_ = false;
+        error_ = nullptr;
+    }
+    poolRows_ = 0;
+    upstreamDone_ = false;
+    worker_ = std::thread(&PrefetchBatchSource::produce, this);
+}
+
+void PrefetchBatchSource::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void PrefetchBatchSource::produce() {
+    while (true) {
+        Batch buffer;
+        {
+            const auto start = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || ready_.size() < options_.depth; });
+            stats_.producerWaitSeconds += utils::secondsSince(start);
+            if (stopping_) {
+                return;
+            }
+            if (!free_.empty()) {
+                buffer = std::move(free_.back());
+                free_.pop_back();
+            }
+        }
+
+        bool more = false;
+        try {
+            more = options_.shuffle ? nextShuffled(buffer) : upstream_.next(buffer);
+            if (more && options_.transform) {
+                options_.transform(buffer);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+            finished_ = true;
+            cv_.notify_all();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!more) {
+            free_.push_back(std::move(buffer));
+            finished_ = true;
+            cv_.notify_all();
+            return;
+        }
+        ready_.push_back(std::move(buffer));
+        cv_.notify_all();
+    }
+}
+
+bool PrefetchBatchSource::nextShuffled(Batch& batch) {
+    const size_t cols = upstream_.cols();
+    const size_t batchRows = upstream_.batchSize();
+    const size_t capacity = std::max(options_.shuffleRows, batchRows);
+    if (pool_.rows() == 0) {
+        // Room for a full buffer plus the upstream batch that tops it up
+        pool_ = utils::Matrix(capacity + batchRows, cols);
+        poolTargets_.resize(capacity + batchRows);
+    }
+
+    while (poolRows_ < capacity && !upstreamDone_) {
+        if (!upstream_.next(incoming_)) {
+            upstreamDone_ = true;
+            break;
+        }
+        if (incoming_.rows() > batchRows) {
+            throw std::runtime_error("Upstream batch is larger than its batch size");
+        }
+        for (size_t i = 0; i < incoming_.rows(); ++i) {
+            const double* row = incoming_.features.rowPtr(i);
+            std::copy(row, row + cols, pool_.rowPtr(poolRows_ + i));
+            poolTargets_[poolRows_ + i] = incoming_.targets[i];
+        }
+        poolRows_ += incoming_.rows();
+    }
+
+    const size_t rows = std::min(batchRows, poolRows_);
+    if (rows == 0) {
+        batch.features = utils::Matrix();
+        batch.targets.clear();
+        return false;
+    }
+    if (batch.features.rows() != rows || batch.features.cols() != cols) {
+        batch.features = utils::Matrix(rows, cols);
+    }
+    batch.targets.resize(rows);
+
+    // Draw without replacement; the last buffered row fills each hole
+    for (size_t i = 0; i < rows; ++i) {
+        const size_t j = std::uniform_int_distribution<size_t>(0, poolRows_ - 1)(rng_);
+        std::copy(pool_.rowPtr(j), pool_.rowPtr(j) + cols, batch.features.rowPtr(i));
+        batch.targets[i] = poolTargets_[j];
+        --poolRows_;
+        if (j != poolRows_) {
+            std::copy(pool_.rowPtr(poolRows_), pool_.rowPtr(poolRows_) + cols, pool_.rowPtr(j));
+            poolTargets_[j] = poolTargets_[poolRows_];
+        }
+    }
+    return true;
+}
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
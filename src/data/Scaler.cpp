@@ -0,0 +1,241 @@
+#include "../../include/data/Scaler.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace ml {
+namespace data {
+
+namespace {
+
+// Rows per independently accumulated block; fixed so results do not depend
+// on how many threads run the blocks
+constexpr size_t kBlockRows = 4096;
+
+} // namespace
+
+ColumnStatistics::ColumnStatistics(size_t cols)
+    : count_(0), mean_(cols, 0.0), m2_(cols, 0.0),
+      min_(cols, std::numeric_limits<double>::infinity()),
+      max_(cols, -std::numeric_limits<double>::infinity()) {}
+
+void ColumnStatistics::add(const utils::MatrixView& rows) {
+    addParallel(rows);
+}
+
+void ColumnStatistics::add(const utils::MatrixViewF& rows) {
+    addParallel(rows);
+}
+
+template <typename T>
+void ColumnStatistics::addRows(const utils::BasicMatrixView<T>& rows, size_t begin, size_t end) {
+    const size_t cols = mean_.size();
+    double* mean = mean_.data();
+    double* m2 = m2_.data();
+    double* lo = min_.data();
+    double* hi = max_.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        const T* row = rows.rowPtr(i);
+        const double invCount = 1.0 / static_cast<double>(++count_);
+        // Independent per column, so the loop vectorizes across the row
+        for (size_t j = 0; j < cols; ++j) {
+            const double x = row[j];
+            const double delta = x - mean[j];
+            mean[j] += delta * invCount;
+            m2[j] += delta * (x - mean[j]);
+            lo[j] = std::min(lo[j], x);
+            hi[j] = std::max(hi[j], x);
+        }
+    }
+}
+
+template <typename T>
+void ColumnStatistics::addParallel(const utils::BasicMatrixView<T>& rows) {
+    if (count_ == 0 && mean_.size() != rows.cols()) {
+        *this = ColumnStatistics(rows.cols());
+    }
+    if (rows.cols() != mean_.size()) {
+        throw std::invalid_argument("Number of columns does not match the accumulated statistics");
+    }
+
+    const size_t blocks = (rows.rows() + kBlockRows - 1) / kBlockRows;
+    if (blocks <= 1) {
+        addRows(rows, 0, rows.rows());
+        return;
+    }
+
+    std::vector<ColumnStatistics> partials(blocks, ColumnStatistics(rows.cols()));
+    utils::parallelFor(0, blocks, 1, [&](size_t lo, size_t hi) {
+        for (size_t b = lo; b < hi; ++b) {
+            partials[b].addRows(rows, b * kBlockRows, std::min(rows.rows(), (b + 1) * kBlockRows));
+        }
+    });
+    for (const ColumnStatistics& partial : partials) {
+        merge(partial);
+    }
+}
+
+void ColumnStatistics::merge(const ColumnStatistics& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    if (other.cols() != cols()) {
+        throw std::invalid_argument("Number of columns does not match the accumulated statistics");
+    }
+
+    const double n1 = static_cast<double>(count_);
+    const double n2 = static_cast<double>(other.count_);
+    const double n = n1 + n2;
+    for (size_t j = 0; j < cols(); ++j) {
+        const double delta = other.mean_[j] - mean_[j];
+        mean_[j] += delta * n2 / n;
+        m2_[j] += other.m2_[j] + delta * delta * n1 * n2 / n;
+        min_[j] = std::min(min_[j], other.min_[j]);
+        max_[j] = std::max(max_[j], other.max_[j]);
+    }
+    count_ += other.count_;
+}
+
+std::vector<double> ColumnStatistics::variance() const {
+    std::vector<double> result(cols(), 0.0);
+    if (count_ > 0) {
+        for (size_t j = 0; j < cols(); ++j) {
+            result[j] = m2_[j] / static_cast<double>(count_);
+        }
+    }
+    return result;
+}
+
+Scaler& Scaler::fit(const utils::MatrixView& features) {
+    statistics_ = ColumnStatistics(features.cols());
+    partialFit(features);
+    return *this;
+}
+
+Scaler& Scaler::fit(const utils::MatrixViewF& features) {
+    statistics_ = ColumnStatistics(features.cols());
+    partialFit(features);
+    return *this;
+}
+
+Scaler& Scaler::fit(BatchSource& source) {
+    statistics_ = ColumnStatistics(source.cols());
+    Batch batch;
+    source.reset();
+    while (source.next(batch)) {
+        statistics_.add(utils::MatrixView(batch.features));
+    }
+    updateTransform();
+    return *this;
+}
+
+void Scaler::partialFit(const utils::MatrixView& features) {
+    statistics_.add(features);
+    updateTransform();
+}
+
+void Scaler::partialFit(const utils::MatrixViewF& features) {
+    statistics_.add(features);
+    updateTransform();
+}
+
+utils::Matrix Scaler::transform(const utils::MatrixView& features) const {
+    utils::Matrix result = features.toMatrix();
+    transformInPlace(result);
+    return result;
+}
+
+utils::MatrixF Scaler::transform(const utils::MatrixViewF& features) const {
+    utils::MatrixF result = features.toMatrix();
+    transformInPlace(result);
+    return result;
+}
+
+void Scaler::transformInPlace(utils::Matrix& features) const {
+    apply(features);
+}
+
+void Scaler::transformInPlace(utils::MatrixF& features) const {
+    apply(features);
+}
+
+void Scaler::inverseTransformInPlace(utils::Matrix& features) const {
+    checkColumns(features.cols());
+    utils::detail::forRows(features.rows(), features.cols(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            double* row = features.rowPtr(i);
+            for (size_t j = 0; j < features.cols(); ++j) {
+                row[j] = row[j] * scale_[j] + offset_[j];
+            }
+        }
+    });
+}
+
+utils::Matrix Scaler::fitTransform(const utils::MatrixView& features) {
+    fit(features);
+    return transform(features);
+}
+
+utils::MatrixF Scaler::fitTransform(const utils::MatrixViewF& features) {
+    fit(features);
+    return transform(features);
+}
+
+template <typename T>
+void Scaler::apply(utils::BasicMatrix<T>& features) const {
+    checkColumns(features.cols());
+
+    // Multiply by the reciprocal so the inner loop is a fused multiply-add
+    std::vector<double> inverse(scale_.size());
+    for (size_t j = 0; j < scale_.size(); ++j) {
+        inverse[j] = 1.0 / scale_[j];
+    }
+
+    utils::detail::forRows(features.rows(), features.cols(), [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* row = features.rowPtr(i);
+            for (size_t j = 0; j < features.cols(); ++j) {
+                row[j] = static_cast<T>((row[j] - offset_[j]) * inverse[j]);
+            }
+        }
+    });
+}
+
+void Scaler::checkColumns(size_t cols) const {
+    if (!isFitted()) {
+        throw std::runtime_error("Scaler must be fitted before transform");
+    }
+    if (cols != offset_.size()) {
+        throw std::invalid_argument("Number of columns does not match the fitted scaler");
+    }
+}
+
+void StandardScaler::updateTransform() {
+    offset_ = statistics_.mean();
+    scale_ = statistics_.variance();
+    for (double& s : scale_) {
+        s = std::sqrt(s);
+        if (s == 0.0) {
+            s = 1.0;
+        }
+    }
+}
+
+void MinMaxScaler::updateTransform() {
+    offset_ = statistics_.min();
+    scale_.resize(statistics_.cols());
+    for (size_t j = 0; j < scale_.size(); ++j) {
+        double range = statistics_.max()[j] - statistics_.min()[j];
+        scale_[j] = range > 0.0 ? range : 1.0;
+    }
+}
+
+} // namespace data
+} // namespace ml
\ No newline at end of file
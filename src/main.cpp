@@ -2,16 +2,20 @@
 #include <memory>
 #include "../include/data/DataLoader.hpp"
 #include "../include/data/DataPreprocessor.hpp"
+#include "../include/data/Scaler.hpp"
 #include "../include/models/LinearRegression.hpp"
 #include "../include/models/LogisticRegression.hpp"
+#include "../include/models/SoftmaxRegression.hpp"
 #include "../include/models/KNNClassifier.hpp"
 #include "../include/models/DecisionTree.hpp"
+#include "../include/models/CrossValidation.hpp"
 #include "../include/utils/Metrics.hpp"
+#include "../include/utils/Workspace.hpp"
 
 using namespace ml;
 
 void evaluateModel(const std::string& modelName,
-                  const utils::Matrix& testFeatures,
+                  const utils::MatrixView& testFeatures,
                   const std::vector<double>& testTargets,
                   const std::vector<double>& predictions) {
     std::cout << "\nEvaluating " << modelName << ":\n";
@@ -31,16 +35,19 @@ int main() {
         }
 
         // Preprocess data
-        auto features = loader.getFeatures();
-        auto targets = loader.getTargets();
-        
-        // Standardize features
-        features = data::DataPreprocessor::standardize(features);
-        
+        const auto& features = loader.getFeatures();
+        const auto& targets = loader.getTargets();
+
         // Split data
         auto [trainData, testData] = data::DataPreprocessor::trainTestSplit(features, targets, 0.8);
-        auto& [trainFeatures, trainTargets] = trainData;
-        auto& [testFeatures, testTargets] = testData;
+        auto& [rawTrainFeatures, trainTargets] = trainData;
+        auto& [rawTestFeatures, testTargets] = testData;
+
+        // Standardize with statistics from the training rows only
+        data::StandardScaler scaler;
+        scaler.fit(rawTrainFeatures);
+        utils::Matrix trainFeatures = scaler.transform(rawTrainFeatures);
+        utils::Matrix testFeatures = scaler.transform(rawTestFeatures);
 
         // Train and evaluate Linear Regression
         {
@@ -60,9 +67,41 @@ int main() {
             }
         }
 
+        // Train and evaluate Softmax Regression (one weight vector per quality level)
+        {
+            models::SoftmaxRegression model;
+            if (model.train(trainFeatures, trainTargets)) {
+                auto predictions = model.predict(testFeatures);
+                evaluateModel("Softmax Regression", testFeatures, testTargets, predictions);
+            }
+        }
+
+        // Refit both gradient-descent models inside a workspace: once a first
+        // fit has sized every buffer, a second fit of the same shape must be
+        // served entirely from the cache and the models' own scratch
+        {
+            utils::Workspace workspace;
+            utils::WorkspaceScope scope(workspace);
+            models::LogisticRegression logistic;
+            models::SoftmaxRegression softmax;
+            logistic.train(trainFeatures, trainTargets);
+            softmax.train(trainFeatures, trainTargets);
+            workspace.resetStats();
+            logistic.train(trainFeatures, trainTargets);
+            softmax.train(trainFeatures, trainTargets);
+
+            const utils::Workspace::Stats stats = workspace.stats();
+            std::cout << "\nWarm refit: " << stats.reused << " buffers reused, "
+                      << stats.heapAllocations << " heap allocations\n";
+            if (stats.heapAllocations != 0) {
+                std::cerr << "Warm refit allocated from the heap\n";
+                return 1;
+            }
+        }
+
         // Train and evaluate KNN Classifier
         {
-            models::KNNClassifier model(5);
+            models::KNNClassifier model(5, models::NeighborSearch::Auto);
             if (model.train(trainFeatures, trainTargets)) {
                 auto predictions = model.predict(testFeatures);
                 evaluateModel("KNN Classifier", testFeatures, testTargets, predictions);
@@ -78,6 +117,20 @@ int main() {
             }
         }
 
+        // Cross-validate the Decision Tree (scale-invariant, so raw features are fine)
+        {
+            auto folds = models::CrossValidation::stratifiedKFold(targets, 5, true, 42);
+            auto result = models::CrossValidation::evaluate(
+                [] { return std::make_unique<models::DecisionTree>(5); },
+                features, targets, folds,
+                {{"Accuracy", utils::Metrics::accuracy}, {"RMSE", utils::Metrics::rootMeanSquaredError}});
+            std::cout << "\nDecision Tree, stratified 5-fold cross-validation:\n";
+            for (size_t m = 0; m < result.metricNames.size(); ++m) {
+                std::cout << result.metricNames[m] << ": " << result.mean(m)
+                          << " +/- " << result.stdDev(m) << "\n";
+            }
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
         return 1;
@@ -0,0 +1,234 @@
+#include "../../include/models/CrossValidation.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include "../../include/utils/Timer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ml {
+namespace models {
+
+namespace {
+
+void checkFoldCount(size_t samples, size_t k) {
+    if (k < 2) {
+        throw std::invalid_argument("Cross-validation needs at least 2 folds");
+    }
+    if (k > samples) {
+        throw std::invalid_argument("Number of folds exceeds the number of samples");
+    }
+}
+
+// Build the folds of one repetition from each row's fold number; walking the
+// rows in order keeps every index list ascending, so fold views gather
+// forward through memory
+void appendFolds(const std::vector<size_t>& foldOf, size_t k, size_t repeat,
+                 std::vector<Fold>& folds) {
+    std::vector<size_t> testSizes(k, 0);
+    for (size_t f : foldOf) {
+        ++testSizes[f];
+    }
+
+    const size_t first = folds.size();
+    for (size_t f = 0; f < k; ++f) {
+        Fold fold;
+        fold.repeat = repeat;
+        fold.index = f;
+        fold.test.reserve(testSizes[f]);
+        fold.train.reserve(foldOf.size() - testSizes[f]);
+        folds.push_back(std::move(fold));
+    }
+    for (size_t row = 0; row < foldOf.size(); ++row) {
+        for (size_t f = 0; f < k; ++f) {
+            (f == foldOf[row] ? folds[first + f].test : folds[first + f].train).push_back(row);
+        }
+    }
+}
+
+void kFoldInto(size_t samples, size_t k, bool shuffle, size_t repeat,
+               std::mt19937_64& rng, std::vector<Fold>& folds) {
+    std::vector<size_t> order(samples);
+    std::iota(order.begin(), order.end(), 0);
+    if (shuffle) {
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+
+    // Position p of the (shuffled) order goes to fold floor(p * k / samples),
+    // giving fold sizes that differ by at most one
+    std::vector<size_t> foldOf(samples);
+    for (size_t p = 0; p < samples; ++p) {
+        foldOf[order[p]] = p * k / samples;
+    }
+    appendFolds(foldOf, k, repeat, folds);
+}
+
+void stratifiedKFoldInto(const std::vector<double>& targets, size_t k, bool shuffle,
+                         size_t repeat, std::mt19937_64& rng, std::vector<Fold>& folds) {
+    std::map<double, std::vector<size_t>> classes;
+    for (size_t row = 0; row < targets.size(); ++row) {
+        classes[targets[row]].push_back(row);
+    }
+
+    // Deal each class to the folds in turn, continuing the count across
+    // classes so fold sizes stay within one of each other
+    std::vector<size_t> foldOf(targets.size());
+    size_t next = 0;
+    for (auto& [label, rows] : classes) {
+        if (shuffle) {
+            std::shuffle(rows.begin(), rows.end(), rng);
+        }
+        for (size_t row : rows) {
+            foldOf[row] = next;
+            next = (next + 1) % k;
+        }
+    }
+    appendFolds(foldOf, k, repeat, folds);
+}
+
+template <typename T>
+CrossValidationResult evaluateImpl(const CrossValidation::ModelFactory& factory,
+                                   const utils::BasicMatrixView<T>& features,
+                                   const std::vector<double>& targets,
+                                   const std::vector<Fold>& folds,
+                                   const std::vector<NamedMetric>& metrics) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
+
+    CrossValidationResult result;
+    for (const NamedMetric& metric : metrics) {
+        result.metricNames.push_back(metric.name);
+    }
+    result.folds.resize(folds.size());
+
+    utils::parallelFor(0, folds.size(), 1, [&](size_t lo, size_t hi) {
+        // Folds are the unit of parallelism; keep each fold's own loops on this thread
+        utils::ThreadLimit serial(1);
+        for (size_t f = lo; f < hi; ++f) {
+            const Fold& fold = folds[f];
+            FoldResult& out = result.folds[f];
+            out.repeat = fold.repeat;
+            out.index = fold.index;
+
+            utils::BasicMatrixView<T> trainFeatures = features.selectRows(fold.train);
+            utils::BasicMatrixView<T> testFeatures = features.selectRows(fold.test);
+            std::vector<double> trainTargets = utils::gather(targets, fold.train);
+            std::vector<double> testTargets = utils::gather(targets, fold.test);
+
+            std::unique_ptr<Model> model = factory();
+            auto start = std::chrono::steady_clock::now();
+            out.trained = model->train(trainFeatures, trainTargets);
+            out.trainSeconds = utils::secondsSince(start);
+            if (!out.trained) {
+                continue;
+            }
+
+            start = std::chrono::steady_clock::now();
+            std::vector<double> predictions = model->predict(testFeatures);
+            out.predictSeconds = utils::secondsSince(start);
+
+            out.scores.reserve(metrics.size());
+            for (const NamedMetric& metric : metrics) {
+                out.scores.push_back(metric.score(testTargets, predictions));
+            }
+        }
+    });
+
+    return result;
+}
+
+} // namespace
+
+double CrossValidationResult::mean(size_t metric) const {
+    if (metric >= metricNames.size()) {
+        throw std::out_of_range("Metric index out of range");
+    }
+    double sum = 0.0;
+    size_t count = 0;
+    for (const FoldResult& fold : folds) {
+        if (fold.trained) {
+            sum += fold.scores[metric];
+            ++count;
+        }
+    }
+    return count > 0 ? sum / static_cast<double>(count) : 0.0;
+}
+
+double CrossValidationResult::stdDev(size_t metric) const {
+    const double average = mean(metric);
+    double sumSquares = 0.0;
+    size_t count = 0;
+    for (const FoldResult& fold : folds) {
+        if (fold.trained) {
+            const double diff = fold.scores[metric] - average;
+            sumSquares += diff * diff;
+            ++count;
+        }
+    }
+    return count > 1 ? std::sqrt(sumSquares / static_cast<double>(count - 1)) : 0.0;
+}
+
+std::vector<Fold> CrossValidation::kFold(size_t samples, size_t k, bool shuffle, uint64_t seed) {
+    checkFoldCount(samples, k);
+    std::mt19937_64 rng(seed);
+    std::vector<Fold> folds;
+    kFoldInto(samples, k, shuffle, 0, rng, folds);
+    return folds;
+}
+
+std::vector<Fold> CrossValidation::stratifiedKFold(const std::vector<double>& targets, size_t k,
+                                                   bool shuffle, uint64_t seed) {
+    checkFoldCount(targets.size(), k);
+    std::mt19937_64 rng(seed);
+    std::vector<Fold> folds;
+    stratifiedKFoldInto(targets, k, shuffle, 0, rng, folds);
+    return folds;
+}
+
+std::vector<Fold> CrossValidation::repeatedKFold(size_t samples, size_t k, size_t repeats,
+                                                 uint64_t seed) {
+    checkFoldCount(samples, k);
+    std::mt19937_64 rng(seed);
+    std::vector<Fold> folds;
+    folds.reserve(k * repeats);
+    for (size_t r = 0; r < repeats; ++r) {
+        kFoldInto(samples, k, true, r, rng, folds);
+    }
+    return folds;
+}
+
+std::vector<Fold> CrossValidation::repeatedStratifiedKFold(const std::vector<double>& targets,
+                                                           size_t k, size_t repeats,
+                                                           uint64_t seed) {
+    checkFoldCount(targets.size(), k);
+    std::mt19937_64 rng(seed);
+    std::vector<Fold> folds;
+    folds.reserve(k * repeats);
+    for (size_t r = 0; r < repeats; ++r) {
+        stratifiedKFoldInto(targets, k, true, r, rng, folds);
+    }
+    return folds;
+}
+
+CrossValidationResult CrossValidation::evaluate(const ModelFactory& factory,
+                                                const utils::MatrixView& features,
+                                                const std::vector<double>& targets,
+                                                const std::vector<Fold>& folds,
+                                                const std::vector<NamedMetric>& metrics) {
+    return evaluateImpl(factory, features, targets, folds, metrics);
+}
+
+CrossValidationResult CrossValidation::evaluate(const ModelFactory& factory,
+                                                const utils::MatrixViewF& features,
+                                                const std::vector<double>& targets,
+                                                const std::vector<Fold>& folds,
+                                                const std::vector<NamedMetric>& metrics) {
+    return evaluateImpl(factory, features, targets, folds, metrics);
+}
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
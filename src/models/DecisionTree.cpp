@@ -3,6 +3,8 @@
 #include <random>
 #include <unordered_map>
 #include <cmath>
+#include <limits>
+#include <numeric>
 
 namespace ml {
 namespace models {
@@ -13,7 +15,25 @@ DecisionTreeNode::DecisionTreeNode(double value)
 DecisionTree::DecisionTree(size_t maxDepth, size_t minSamplesSplit, size_t maxFeatures)
     : maxDepth_(maxDepth), minSamplesSplit_(minSamplesSplit), maxFeatures_(maxFeatures) {}
 
-bool DecisionTree::train(const utils::Matrix& features, const std::vector<double>& targets) {
+bool DecisionTree::train(const utils::MatrixView& features, const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+bool DecisionTree::train(const utils::MatrixViewF& features, const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+std::vector<double> DecisionTree::predict(const utils::MatrixView& features) const {
+    return predictRows(features);
+}
+
+std::vector<double> DecisionTree::predict(const utils::MatrixViewF& features) const {
+    return predictRows(features);
+}
+
+template <typename T>
+bool DecisionTree::fit(const utils::BasicMatrixView<T>& features,
+                       const std::vector<double>& targets) {
     if (features.rows() != targets.size() || features.rows() == 0) {
         return false;
     }
@@ -22,18 +42,21 @@ bool DecisionTree::train(const utils::Matrix& features, const std::vector<double
         maxFeatures_ = features.cols();
     }
 
-    root_ = buildTree(features, targets, 0);
+    std::vector<size_t> indices(features.rows());
+    std::iota(indices.begin(), indices.end(), 0);
+    root_ = buildTree(features, targets, indices, 0, indices.size(), 0);
     return true;
 }
 
-std::vector<double> DecisionTree::predict(const utils::Matrix& features) const {
+template <typename T>
+std::vector<double> DecisionTree::predictRows(const utils::BasicMatrixView<T>& features) const {
     std::vector<double> predictions;
     predictions.reserve(features.rows());
 
     for (size_t i = 0; i < features.rows(); ++i) {
         const DecisionTreeNode* node = root_.get();
         while (node->left && node->right) {
-            if (features[i][node->featureIndex] <= node->threshold) {
+            if (features(i, node->featureIndex) <= node->threshold) {
                 node = node->left.get();
             } else {
                 node = node->right.get();
@@ -50,16 +73,28 @@ std::vector<double> DecisionTree::getParameters() const {
     return std::vector<double>();
 }
 
+template <typename T>
 std::unique_ptr<DecisionTreeNode> DecisionTree::buildTree(
-    const utils::Matrix& features,
+    const utils::BasicMatrixView<T>& features,
     const std::vector<double>& targets,
+    std::vector<size_t>& indices,
+    size_t begin, size_t end,
     size_t depth) {
     
+    const size_t numSamples = end - begin;
+    auto meanTarget = [&]() {
+        double sum = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            sum += targets[indices[i]];
+        }
+        return sum / numSamples;
+    };
+
     // Create leaf node if stopping criteria are met
-    if (depth >= maxDepth_ || targets.size() < minSamplesSplit_) {
+    if (depth >= maxDepth_ || numSamples < minSamplesSplit_) {
         double leafValue = 0.0;
-        if (!targets.empty()) {
-            leafValue = std::accumulate(targets.begin(), targets.end(), 0.0) / targets.size();
+        if (numSamples > 0) {
+            leafValue = meanTarget();
         }
         return std::make_unique<DecisionTreeNode>(leafValue);
     }
@@ -81,7 +116,7 @@ std::unique_ptr<DecisionTreeNode> DecisionTree::buildTree(
     }
 
     for (size_t featureIdx : featureIndices) {
-        auto [threshold, gini] = findBestSplit(features, targets, featureIdx);
+        auto [threshold, gini] = findBestSplit(features, targets, indices, begin, end, featureIdx);
         if (gini < bestGini) {
             bestGini = gini;
             bestFeature = featureIdx;
@@ -91,31 +126,22 @@ std::unique_ptr<DecisionTreeNode> DecisionTree::buildTree(
 
     // If no improvement in Gini, create leaf node
     if (bestGini == std::numeric_limits<double>::infinity()) {
-        double leafValue = std::accumulate(targets.begin(), targets.end(), 0.0) / targets.size();
-        return std::make_unique<DecisionTreeNode>(leafValue);
+        return std::make_unique<DecisionTreeNode>(meanTarget());
     }
 
-    // Split data
-    utils::Matrix leftFeatures(0, features.cols());
-    utils::Matrix rightFeatures(0, features.cols());
-    std::vector<double> leftTargets, rightTargets;
-
-    for (size_t i = 0; i < features.rows(); ++i) {
-        if (features[i][bestFeature] <= bestThreshold) {
-            leftFeatures = utils::Matrix(std::vector<std::vector<double>>{features[i]});
-            leftTargets.push_back(targets[i]);
-        } else {
-            rightFeatures = utils::Matrix(std::vector<std::vector<double>>{features[i]});
-            rightTargets.push_back(targets[i]);
-        }
-    }
+    // Split data by reordering this node's slice of the index array
+    auto middle = std::partition(indices.begin() + begin, indices.begin() + end,
+                                 [&](size_t row) {
+                                     return features(row, bestFeature) <= bestThreshold;
+                                 });
+    size_t split = static_cast<size_t>(middle - indices.begin());
 
     // Create node and recursively build subtrees
     auto node = std::make_unique<DecisionTreeNode>(0.0);
     node->featureIndex = bestFeature;
     node->threshold = bestThreshold;
-    node->left = buildTree(leftFeatures, leftTargets, depth + 1);
-    node->right = buildTree(rightFeatures, rightTargets, depth + 1);
+    node->left = buildTree(features, targets, indices, begin, split, depth + 1);
+    node->right = buildTree(features, targets, indices, split, end, depth + 1);
 
     return node;
 }
@@ -139,16 +165,19 @@ double DecisionTree::calculateGini(const std::vector<double>& targets) {
     return gini;
 }
 
+template <typename T>
 std::pair<double, double> DecisionTree::findBestSplit(
-    const utils::Matrix& features,
+    const utils::BasicMatrixView<T>& features,
     const std::vector<double>& targets,
+    const std::vector<size_t>& indices,
+    size_t begin, size_t end,
     size_t featureIndex) {
     
     std::vector<std::pair<double, double>> featureTargetPairs;
-    featureTargetPairs.reserve(features.rows());
+    featureTargetPairs.reserve(end - begin);
     
-    for (size_t i = 0; i < features.rows(); ++i) {
-        featureTargetPairs.emplace_back(features[i][featureIndex], targets[i]);
+    for (size_t i = begin; i < end; ++i) {
+        featureTargetPairs.emplace_back(features(indices[i], featureIndex), targets[indices[i]]);
     }
     
     std::sort(featureTargetPairs.begin(), featureTargetPairs.end());
@@ -170,7 +199,7 @@ std::pair<double, double> DecisionTree::findBestSplit(
             }
             
             double gini = (leftTargets.size() * calculateGini(leftTargets) +
-                         rightTargets.size() * calculateGini(rightTargets)) / features.rows();
+                         rightTargets.size() * calculateGini(rightTargets)) / featureTargetPairs.size();
             
             if (gini < bestGini) {
                 bestGini = gini;
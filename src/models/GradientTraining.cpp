@@ -0,0 +1,110 @@
+#include "../../include/models/GradientTraining.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ml {
+namespace models {
+
+namespace {
+
+// Partial-sum blocks cover at least kMinBlockRows rows, and grow with the
+// row count so there are never more than kMaxBlocks of them: the partials
+// buffer and the serial reduction then stay bounded by kMaxBlocks slots
+constexpr size_t kMinBlockRows = 64;
+constexpr size_t kMaxBlocks = 256;
+
+}
+
+void validateMiniBatchOptions(const MiniBatchOptions& options) {
+    if (options.epochs == 0) {
+        throw std::invalid_argument("Mini-batch training needs at least one epoch");
+    }
+}
+
+double maxAbs(const std::vector<double>& values) {
+    double result = 0.0;
+    for (double v : values) {
+        result = std::max(result, std::abs(v));
+    }
+    return result;
+}
+
+MiniBatchRun runMiniBatches(size_t rows, const MiniBatchOptions& options, double tolerance,
+                            Optimizer& optimizer, std::vector<double>& parameters,
+                            utils::FunctionRef<void(const std::vector<size_t>&)> reorder,
+                            utils::FunctionRef<double(size_t, size_t, std::vector<double>&)> batchLoss) {
+    MiniBatchRun run;
+    optimizer.reset(parameters.size());
+    if (rows == 0) {
+        return run;
+    }
+
+    const size_t batchSize = options.batchSize == 0 ? rows : std::min(options.batchSize, rows);
+    std::mt19937_64 rng(options.seed);
+    std::vector<size_t> order(rows);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<double> gradient(parameters.size());
+
+    for (size_t epoch = 0; epoch < options.epochs; ++epoch) {
+        optimizer.beginEpoch(epoch);
+        if (options.shuffle) {
+            std::shuffle(order.begin(), order.end(), rng);
+            reorder(order);
+        }
+
+        double epochLoss = 0.0;
+        for (size_t begin = 0; begin < rows; begin += batchSize) {
+            const size_t end = std::min(rows, begin + batchSize);
+            epochLoss += batchLoss(begin, end, gradient) * static_cast<double>(end - begin);
+            optimizer.step(parameters, gradient);
+        }
+        run.epochs = epoch + 1;
+        run.loss = epochLoss / static_cast<double>(rows);
+        if (run.loss < tolerance) {
+            run.converged = true;
+            break;
+        }
+    }
+    return run;
+}
+
+double reduceBlocks(size_t rows, std::vector<double>& gradient, std::vector<double>& partials,
+                    utils::FunctionRef<void(size_t, size_t, double*)> fill) {
+    const size_t size = gradient.size();
+    // Depends only on the row count, so the summation order is fixed too
+    const size_t blockRows = std::max(kMinBlockRows, (rows + kMaxBlocks - 1) / kMaxBlocks);
+    const size_t blocks = (rows + blockRows - 1) / blockRows;
+    partials.assign(blocks * (size + 1), 0.0);
+
+    utils::parallelFor(0, blocks, 1, [&](size_t lo, size_t hi) {
+        // Blocks are the unit of parallelism; keep any gemm inside one on this thread
+        utils::ThreadLimit serial(1);
+        for (size_t b = lo; b < hi; ++b) {
+            const size_t first = b * blockRows;
+            fill(first, std::min(rows, first + blockRows) - first, partials.data() + b * (size + 1));
+        }
+    });
+
+    std::fill(gradient.begin(), gradient.end(), 0.0);
+    double loss = 0.0;
+    for (size_t b = 0; b < blocks; ++b) {
+        const double* slot = partials.data() + b * (size + 1);
+        for (size_t j = 0; j < size; ++j) {
+            gradient[j] += slot[j];
+        }
+        loss += slot[size];
+    }
+
+    const double scale = rows > 0 ? 1.0 / static_cast<double>(rows) : 0.0;
+    for (double& g : gradient) {
+        g *= scale;
+    }
+    return loss * scale;
+}
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
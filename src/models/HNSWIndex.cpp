@@ -0,0 +1,299 @@
+#include "../../include/models/HNSWIndex.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace ml {
+namespace models {
+
+namespace {
+
+// Nodes inserted per parallel chunk
+constexpr size_t kInsertGrain = 256;
+
+constexpr size_t kMaxLevel = std::numeric_limits<uint8_t>::max();
+
+// Orders a heap so its front is the closest candidate
+bool fartherThan(const Neighbor& a, const Neighbor& b) {
+    return b < a;
+}
+
+} // namespace
+
+template <typename T>
+void HNSWIndex<T>::VisitedSet::reset(size_t size) {
+    if (marks.size() != size || epoch == std::numeric_limits<uint32_t>::max()) {
+        marks.assign(size, 0);
+        epoch = 0;
+    }
+    ++epoch;
+}
+
+template <typename T>
+bool HNSWIndex<T>::VisitedSet::insert(uint32_t node) {
+    if (marks[node] == epoch) {
+        return false;
+    }
+    marks[node] = epoch;
+    return true;
+}
+
+template <typename T>
+typename HNSWIndex<T>::VisitedSet& HNSWIndex<T>::visitedSet(size_t size) {
+    // One per thread, kept between searches so a query never allocates
+    thread_local VisitedSet visited;
+    visited.reset(size);
+    return visited;
+}
+
+template <typename T>
+HNSWIndex<T>::HNSWIndex(const utils::BasicMatrixView<T>& points, const HNSWOptions& options)
+    : M_(options.M), efConstruction_(options.efConstruction) {
+    if (options.M < 2) {
+        throw std::invalid_argument("HNSW needs at least 2 links per node");
+    }
+    if (options.efConstruction == 0) {
+        throw std::invalid_argument("HNSW construction candidate list must not be empty");
+    }
+    const size_t n = points.rows();
+    if (n >= std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("HNSW index supports fewer than 2^32 rows");
+    }
+    if (n == 0) {
+        return;
+    }
+
+    points_ = points.template toMatrix<T>();
+
+    // Level l is reached with probability M^-l
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double scale = 1.0 / std::log(static_cast<double>(M_));
+    levels_.resize(n);
+    upper_.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double level = std::floor(-std::log(1.0 - uniform(rng)) * scale);
+        levels_[i] = static_cast<uint8_t>(std::min<double>(level, kMaxLevel));
+        upper_[i].assign(levels_[i] * (M_ + 1), 0);
+    }
+    base_.assign(n * (2 * M_ + 1), 0);
+    locks_.reset(new std::mutex[n + 1]);
+
+    entry_ = 0;
+    maxLevel_ = levels_[0];
+    utils::parallelFor(1, n, kInsertGrain, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            insert(static_cast<uint32_t>(i));
+        }
+    });
+}
+
+template <typename T>
+uint32_t* HNSWIndex<T>::links(uint32_t node, size_t layer) {
+    if (layer == 0) {
+        return base_.data() + node * (2 * M_ + 1);
+    }
+    return upper_[node].data() + (layer - 1) * (M_ + 1);
+}
+
+template <typename T>
+const uint32_t* HNSWIndex<T>::links(uint32_t node, size_t layer) const {
+    if (layer == 0) {
+        return base_.data() + node * (2 * M_ + 1);
+    }
+    return upper_[node].data() + (layer - 1) * (M_ + 1);
+}
+
+template <typename T>
+void HNSWIndex<T>::readLinks(uint32_t node, size_t layer, bool locked,
+                             std::vector<uint32_t>& out) const {
+    std::unique_lock<std::mutex> guard(locks_[node], std::defer_lock);
+    if (locked) {
+        guard.lock();
+    }
+    const uint32_t* list = links(node, layer);
+    out.assign(list + 1, list + 1 + list[0]);
+}
+
+template <typename T>
+void HNSWIndex<T>::insert(uint32_t node) {
+    const T* point = points_.rowPtr(node);
+    const size_t level = levels_[node];
+
+    // Only a node that raises the top level keeps the entry lock for its
+    // whole insertion; everyone else just reads the current entry point
+    std::unique_lock<std::mutex> entryGuard(locks_[size()]);
+    uint32_t entry = entry_;
+    const size_t top = maxLevel_;
+    if (level <= top) {
+        entryGuard.unlock();
+    }
+
+    for (size_t layer = top; layer > level; --layer) {
+        entry = greedy(point, entry, layer, true);
+    }
+
+    std::vector<Neighbor> candidates;
+    std::vector<Neighbor> pruned;
+    for (size_t layer = std::min(level, top) + 1; layer-- > 0;) {
+        searchLayer(point, entry, efConstruction_, layer, true, candidates);
+        entry = static_cast<uint32_t>(candidates.front().index);
+        selectNeighbors(candidates, M_);
+
+        {
+            std::lock_guard<std::mutex> guard(locks_[node]);
+            uint32_t* list = links(node, layer);
+            list[0] = static_cast<uint32_t>(candidates.size());
+            for (size_t j = 0; j < candidates.size(); ++j) {
+                list[1 + j] = static_cast<uint32_t>(candidates[j].index);
+            }
+        }
+
+        // Link back, re-pruning any neighbour whose list is already full
+        const size_t limit = capacity(layer);
+        for (const Neighbor& candidate : candidates) {
+            const uint32_t other = static_cast<uint32_t>(candidate.index);
+            std::lock_guard<std::mutex> guard(locks_[other]);
+            uint32_t* list = links(other, layer);
+            if (list[0] < limit) {
+                list[1 + list[0]] = node;
+                ++list[0];
+                continue;
+            }
+
+            const T* base = points_.rowPtr(other);
+            pruned.clear();
+            pruned.push_back({candidate.distance, node});
+            for (uint32_t j = 0; j < list[0]; ++j) {
+                pruned.push_back({distance(base, list[1 + j]), list[1 + j]});
+            }
+            std::sort(pruned.begin(), pruned.end());
+            selectNeighbors(pruned, limit);
+            list[0] = static_cast<uint32_t>(pruned.size());
+            for (size_t j = 0; j < pruned.size(); ++j) {
+                list[1 + j] = static_cast<uint32_t>(pruned[j].index);
+            }
+        }
+    }
+
+    if (level > top) {
+        entry_ = node;
+        maxLevel_ = level;
+    }
+}
+
+template <typename T>
+uint32_t HNSWIndex<T>::greedy(const T* point, uint32_t entry, size_t layer, bool locked) const {
+    uint32_t current = entry;
+    double best = distance(point, current);
+    std::vector<uint32_t> neighbors;
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        readLinks(current, layer, locked, neighbors);
+        for (uint32_t next : neighbors) {
+            const double d = distance(point, next);
+            if (d < best) {
+                best = d;
+                current = next;
+                moved = true;
+            }
+        }
+    }
+    return current;
+}
+
+template <typename T>
+void HNSWIndex<T>::searchLayer(const T* point, uint32_t entry, size_t ef, size_t layer,
+                               bool locked, std::vector<Neighbor>& out) const {
+    VisitedSet& visited = visitedSet(size());
+    NeighborHeap results(ef);
+    std::vector<Neighbor> frontier;
+    std::vector<uint32_t> neighbors;
+
+    const double start = distance(point, entry);
+    visited.insert(entry);
+    results.push(start, entry);
+    frontier.push_back({start, entry});
+
+    while (!frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), fartherThan);
+        const Neighbor closest = frontier.back();
+        frontier.pop_back();
+        if (results.full() && closest.distance > results.worst()) {
+            break;
+        }
+
+        readLinks(static_cast<uint32_t>(closest.index), layer, locked, neighbors);
+        for (uint32_t next : neighbors) {
+            if (!visited.insert(next)) {
+                continue;
+            }
+            const double d = distance(point, next);
+            if (!results.full() || d < results.worst()) {
+                results.push(d, next);
+                frontier.push_back({d, next});
+                std::push_heap(frontier.begin(), frontier.end(), fartherThan);
+            }
+        }
+    }
+
+    results.sortedInto(out);
+}
+
+template <typename T>
+void HNSWIndex<T>::selectNeighbors(std::vector<Neighbor>& candidates, size_t limit) const {
+    if (candidates.size() <= limit) {
+        return;
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < candidates.size() && kept < limit; ++i) {
+        const T* row = points_.rowPtr(candidates[i].index);
+        bool diverse = true;
+        // Keep a candidate unless some kept neighbour is strictly closer to
+        // it than the node is; ties keep it (hnswlib's rule), so exact
+        // duplicates at distance 0 still link to one another
+        for (size_t j = 0; j < kept && diverse; ++j) {
+            diverse = distance(row, static_cast<uint32_t>(candidates[j].index)) >= candidates[i].distance;
+        }
+        if (diverse) {
+            candidates[kept++] = candidates[i];
+        }
+    }
+    candidates.resize(kept);
+}
+
+template <typename T>
+void HNSWIndex<T>::query(const T* point, size_t k, size_t ef, std::vector<Neighbor>& out) const {
+    out.clear();
+    if (k == 0 || empty()) {
+        return;
+    }
+    uint32_t entry = entry_;
+    for (size_t layer = maxLevel_; layer > 0; --layer) {
+        entry = greedy(point, entry, layer, false);
+    }
+    searchLayer(point, entry, std::max(ef, k), 0, false, out);
+    if (out.size() > k) {
+        out.resize(k);
+    }
+}
+
+template <typename T>
+size_t HNSWIndex<T>::memoryBytes() const {
+    size_t upper = 0;
+    for (const std::vector<uint32_t>& links : upper_) {
+        upper += links.size();
+    }
+    return points_.rows() * points_.stride() * sizeof(T) + levels_.size() +
+           (base_.size() + upper) * sizeof(uint32_t);
+}
+
+template class HNSWIndex<float>;
+template class HNSWIndex<double>;
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
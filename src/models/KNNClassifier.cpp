@@ -1,73 +1,466 @@
 #include "../../include/models/KNNClassifier.hpp"
+#include "../../include/utils/Gemm.hpp"
+#include "../../include/utils/ThreadPool.hpp"
 #include <algorithm>
-#include <cmath>
+#include <iterator>
 #include <stdexcept>
 #include <map>
 
 namespace ml {
 namespace models {
 
-KNNClassifier::KNNClassifier(size_t k) : k_(k) {}
+namespace {
 
-bool KNNClassifier::train(const utils::Matrix& features,
+// Queries per parallel chunk for tree and sparse searches
+constexpr size_t kQueryGrain = 16;
+
+// Brute-force tiles: each gemm scores kQueryTile queries against
+// kReferenceTile references, a dot-product block small enough to stay in cache
+constexpr size_t kQueryTile = 64;
+constexpr size_t kReferenceTile = 512;
+
+template <typename T>
+std::vector<double> rowSquaredNorms(const utils::BasicMatrixView<T>& features) {
+    std::vector<double> norms(features.rows());
+    for (size_t i = 0; i < features.rows(); ++i) {
+        const T* row = features.rowPtr(i);
+        double sum = 0.0;
+        for (size_t c = 0; c < features.cols(); ++c) {
+            sum += static_cast<double>(row[c]) * row[c];
+        }
+        norms[i] = sum;
+    }
+    return norms;
+}
+
+} // namespace
+
+KNNClassifier::KNNClassifier(size_t k, NeighborSearch search, size_t leafSize)
+    : k_(k), search_(search), leafSize_(leafSize) {}
+
+bool KNNClassifier::train(const utils::MatrixView& features,
                           const std::vector<double>& targets) {
     if (features.rows() != targets.size()) {
         throw std::invalid_argument("Number of samples in features and targets must match");
     }
 
-    trainFeatures_ = features;
+    trainDense(dense_, features);
+    denseF_ = DenseReferences<float>();
+    trainSparse_ = utils::SparseMatrix();
+    sparseNorms_.clear();
+    storage_ = Storage::Dense;
     trainTargets_ = targets;
 
     return true;
 }
 
-std::vector<double> KNNClassifier::predict(const utils::Matrix& features) const {
-    std::vector<double> predictions(features.rows());
+bool KNNClassifier::train(const utils::MatrixViewF& features,
+                          const std::vector<double>& targets) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
 
-    for (size_t i = 0; i < features.rows(); ++i) {
-        std::vector<std::pair<double, double>> distances;
-        for (size_t j = 0; j < trainFeatures_.rows(); ++j) {
-            double distance = euclideanDistance(features[i], trainFeatures_[j]);
-            distances.emplace_back(distance, trainTargets_[j]);
+    trainDense(denseF_, features);
+    dense_ = DenseReferences<double>();
+    trainSparse_ = utils::SparseMatrix();
+    sparseNorms_.clear();
+    storage_ = Storage::DenseF;
+    trainTargets_ = targets;
+
+    return true;
+}
+
+bool KNNClassifier::train(const utils::SparseMatrix& features,
+                          const std::vector<double>& targets) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
+
+    trainSparse_ = features.toCSR();
+    sparseNorms_ = trainSparse_.rowSquaredNorms();
+    dense_ = DenseReferences<double>();
+    denseF_ = DenseReferences<float>();
+    storage_ = Storage::Sparse;
+    trainTargets_ = targets;
+
+    return true;
+}
+
+void KNNClassifier::setHNSWOptions(const HNSWOptions& options) {
+    if (options.M < 2) {
+        throw std::invalid_argument("HNSW needs at least 2 links per node");
+    }
+    if (options.efConstruction == 0) {
+        throw std::invalid_argument("HNSW construction candidate list must not be empty");
+    }
+    hnsw_ = options;
+}
+
+void KNNClassifier::setQuantization(const QuantizationOptions& options) {
+    if (options.kind == Quantization::Product &&
+        (options.subspaces == 0 || options.centroids == 0 || options.centroids > 256)) {
+        throw std::invalid_argument("Product quantization needs subspaces and 1 to 256 centroids");
+    }
+    quantization_ = options;
+}
+
+size_t KNNClassifier::referenceBytes() const {
+    switch (storage_) {
+        case Storage::Dense:
+            return dense_.memoryBytes();
+        case Storage::DenseF:
+            return denseF_.memoryBytes();
+        case Storage::Sparse:
+        default:
+            return trainSparse_.nonZeros() * (sizeof(double) + sizeof(size_t)) +
+                   (trainSparse_.outerSize() + 1) * sizeof(size_t) +
+                   sparseNorms_.size() * sizeof(double);
+    }
+}
+
+double KNNClassifier::recall(const utils::MatrixView& queries) const {
+    return recallDense(queries);
+}
+
+double KNNClassifier::recall(const utils::MatrixViewF& queries) const {
+    return recallDense(queries);
+}
+
+std::vector<double> KNNClassifier::predict(const utils::MatrixView& features) const {
+    return predictDense(features);
+}
+
+std::vector<double> KNNClassifier::predict(const utils::MatrixViewF& features) const {
+    return predictDense(features);
+}
+
+std::vector<double> KNNClassifier::predict(const utils::SparseMatrix& features) const {
+    const utils::SparseMatrix queries = features.toCSR();
+    std::vector<double> predictions(queries.rows());
+
+    if (storage_ != Storage::Sparse) {
+        // Dense references: expand a tile of query rows at a time
+        utils::Matrix tile;
+        for (size_t begin = 0; begin < queries.rows(); begin += kQueryTile) {
+            const size_t count = std::min(queries.rows() - begin, kQueryTile);
+            tile = utils::Matrix(count, queries.cols());
+            for (size_t i = 0; i < count; ++i) {
+                utils::Span<const size_t> indices = queries.innerIndices(begin + i);
+                utils::Span<const double> values = queries.innerValues(begin + i);
+                for (size_t p = 0; p < indices.size(); ++p) {
+                    tile(i, indices[p]) = values[p];
+                }
+            }
+            const std::vector<double> tilePredictions = predictDense(utils::MatrixView(tile));
+            std::copy(tilePredictions.begin(), tilePredictions.end(), predictions.begin() + begin);
         }
+        return predictions;
+    }
 
-        std::partial_sort(distances.begin(), distances.begin() + k_, distances.end());
+    if (queries.cols() != trainSparse_.cols()) {
+        throw std::invalid_argument("Vectors must have the same dimension");
+    }
 
-        std::map<double, int> classVotes;
-        for (size_t j = 0; j < k_; ++j) {
-            ++classVotes[distances[j].second];
+    // |a - b|^2 = |a|^2 + |b|^2 - 2 a.b, with the dot product over shared nonzeros
+    const std::vector<double> queryNorms = queries.rowSquaredNorms();
+    utils::parallelFor(0, queries.rows(), kQueryGrain, [&](size_t lo, size_t hi) {
+        NeighborHeap heap;
+        std::vector<Neighbor> neighbors;
+        for (size_t i = lo; i < hi; ++i) {
+            heap.reset(std::min(k_, trainSparse_.rows()));
+            for (size_t j = 0; j < trainSparse_.rows(); ++j) {
+                double dot = utils::sparseDot(queries.innerIndices(i), queries.innerValues(i),
+                                              trainSparse_.innerIndices(j), trainSparse_.innerValues(j));
+                heap.push(std::max(0.0, queryNorms[i] + sparseNorms_[j] - 2.0 * dot), j);
+            }
+            heap.sortedInto(neighbors);
+            predictions[i] = vote(neighbors);
         }
+    });
 
-        auto maxVote = std::max_element(
-            classVotes.begin(), classVotes.end(),
-            [](const std::pair<double, int>& p1, const std::pair<double, int>& p2) {
-                return p1.second < p2.second;
-            });
+    return predictions;
+}
 
-        predictions[i] = maxVote->first;
+template <typename T>
+void KNNClassifier::trainDense(DenseReferences<T>& references,
+                               const utils::BasicMatrixView<T>& features) {
+    references = DenseReferences<T>();
+    if (quantization_.kind != Quantization::None) {
+        references.codes = QuantizedIndex(features, quantization_);
+        references.rerank = quantization_.rerank;
+        // Without re-ranking the full-precision rows are never read again
+        if (references.rerank > 0) {
+            references.features = features.template toMatrix<T>();
+        }
+        return;
     }
 
-    return predictions;
+    switch (search_) {
+        case NeighborSearch::KDTree:
+            references.tree = SpatialIndex<T>(features, SpatialIndexKind::KDTree, leafSize_);
+            break;
+        case NeighborSearch::BallTree:
+            references.tree = SpatialIndex<T>(features, SpatialIndexKind::BallTree, leafSize_);
+            break;
+        case NeighborSearch::Auto:
+            references.tree = SpatialIndex<T>(features,
+                                              features.cols() <= kAutoKDTreeDims
+                                                  ? SpatialIndexKind::KDTree
+                                                  : SpatialIndexKind::BallTree,
+                                              leafSize_);
+            break;
+        case NeighborSearch::HNSW:
+            references.graph = HNSWIndex<T>(features, hnsw_);
+            break;
+        case NeighborSearch::BruteForce:
+        default:
+            references.features = features.template toMatrix<T>();
+            references.norms = rowSquaredNorms(features);
+            break;
+    }
 }
 
-std::vector<double> KNNClassifier::getParameters() const {
-    // KNN doesn't have parameters in the traditional sense
-    return {};
+template <typename Q>
+std::vector<double> KNNClassifier::predictDense(const utils::BasicMatrixView<Q>& queries) const {
+    std::vector<double> predictions(queries.rows());
+    auto voteInto = [&](size_t query, std::vector<Neighbor>& neighbors) {
+        predictions[query] = vote(neighbors);
+    };
+    if (storage_ == Storage::Dense) {
+        searchDense(dense_, queries, false, voteInto);
+        return predictions;
+    }
+    if (storage_ == Storage::DenseF) {
+        searchDense(denseF_, queries, false, voteInto);
+        return predictions;
+    }
+
+    if (queries.cols() != trainSparse_.cols()) {
+        throw std::invalid_argument("Vectors must have the same dimension");
+    }
+
+    // Sparse references: only their nonzeros touch the dense query
+    const std::vector<double> queryNorms = rowSquaredNorms(queries);
+    utils::parallelFor(0, queries.rows(), kQueryGrain, [&](size_t lo, size_t hi) {
+        NeighborHeap heap;
+        std::vector<Neighbor> neighbors;
+        for (size_t i = lo; i < hi; ++i) {
+            const Q* query = queries.rowPtr(i);
+            heap.reset(std::min(k_, trainSparse_.rows()));
+            for (size_t j = 0; j < trainSparse_.rows(); ++j) {
+                utils::Span<const size_t> indices = trainSparse_.innerIndices(j);
+                utils::Span<const double> values = trainSparse_.innerValues(j);
+                double dot = 0.0;
+                for (size_t p = 0; p < indices.size(); ++p) {
+                    dot += values[p] * query[indices[p]];
+                }
+                heap.push(std::max(0.0, queryNorms[i] + sparseNorms_[j] - 2.0 * dot), j);
+            }
+            heap.sortedInto(neighbors);
+            predictions[i] = vote(neighbors);
+        }
+    });
+
+    return predictions;
 }
 
-double KNNClassifier::euclideanDistance(const std::vector<double>& a,
-                                        const std::vector<double>& b) {
-    if (a.size() != b.size()) {
+template <typename R, typename Q, typename Visit>
+void KNNClassifier::searchDense(const DenseReferences<R>& references,
+                                const utils::BasicMatrixView<Q>& queries,
+                                bool exact, const Visit& visit) const {
+    const bool quantized = !references.codes.empty();
+    const size_t dims = references.dims();
+    if (queries.cols() != dims) {
         throw std::invalid_argument("Vectors must have the same dimension");
     }
+    if (exact && quantized && references.rerank == 0) {
+        throw std::runtime_error("Exact search needs the full-precision references; "
+                                 "enable re-ranking to keep them");
+    }
+    if (exact || (!quantized && references.tree.empty() && references.graph.empty())) {
+        // Only the brute-force strategy keeps norms; recall() on an index
+        // or re-ranked codes derives them here
+        if (references.norms.empty()) {
+            bruteForce(references.rows(), rowSquaredNorms(references.rows()), queries, visit);
+        } else {
+            bruteForce(references.rows(), references.norms, queries, visit);
+        }
+        return;
+    }
+
+    utils::parallelFor(0, queries.rows(), kQueryGrain, [&](size_t lo, size_t hi) {
+        std::vector<R> query(queries.cols());
+        std::vector<Neighbor> neighbors;
+        std::vector<Neighbor> shortlist;
+        NeighborHeap heap;
+        for (size_t i = lo; i < hi; ++i) {
+            const Q* row = queries.rowPtr(i);
+            std::copy(row, row + queries.cols(), query.begin());
+            if (quantized && references.rerank > 0) {
+                // Rescore the approximate shortlist against the full-precision rows
+                references.codes.query(query.data(), std::max(k_, references.rerank), shortlist);
+                heap.reset(std::min(k_, shortlist.size()));
+                for (const Neighbor& candidate : shortlist) {
+                    heap.push(squaredDistance(query.data(),
+                                              references.features.rowPtr(candidate.index), dims),
+                              candidate.index);
+                }
+                heap.sortedInto(neighbors);
+            } else if (quantized) {
+                references.codes.query(query.data(), k_, neighbors);
+            } else if (!references.tree.empty()) {
+                references.tree.query(query.data(), k_, neighbors);
+            } else {
+                references.graph.query(query.data(), k_, hnsw_.efSearch, neighbors);
+            }
+            visit(i, neighbors);
+        }
+    });
+}
+
+template <typename R, typename Q, typename Visit>
+void KNNClassifier::bruteForce(const utils::BasicMatrixView<R>& references,
+                               const std::vector<double>& referenceNorms,
+                               const utils::BasicMatrixView<Q>& queries,
+                               const Visit& visit) const {
+    // |q - r|^2 = |q|^2 - 2 q.r + |r|^2: the dot products of a query tile
+    // against a reference tile are one gemm in the precision of the stored
+    // references, the reference norms are precomputed, and ranking needs no sqrt.
+    // Each query tile keeps its own bounded heaps, so only k candidates per
+    // query are ever held.
+    const size_t n = references.rows();
+    const size_t dims = references.cols();
+    const size_t tiles = (queries.rows() + kQueryTile - 1) / kQueryTile;
+    utils::parallelFor(0, tiles, 1, [&](size_t lo, size_t hi) {
+        // Tiles are the unit of parallelism; keep each tile's gemm on this thread
+        utils::ThreadLimit serial(1);
+        utils::BasicMatrix<R> queryBlock(kQueryTile, dims);
+        utils::BasicMatrix<R> referenceBlock;
+        utils::BasicMatrix<R> dots(kQueryTile, kReferenceTile);
+        std::vector<double> queryNorms(kQueryTile);
+        std::vector<NeighborHeap> heaps(kQueryTile);
+        std::vector<Neighbor> neighbors;
+
+        for (size_t t = lo; t < hi; ++t) {
+            const size_t first = t * kQueryTile;
+            const size_t count = std::min(queries.rows() - first, kQueryTile);
+            for (size_t i = 0; i < count; ++i) {
+                const Q* row = queries.rowPtr(first + i);
+                R* query = queryBlock.rowPtr(i);
+                std::copy(row, row + dims, query);
+                double norm = 0.0;
+                for (size_t c = 0; c < dims; ++c) {
+                    norm += static_cast<double>(query[c]) * query[c];
+                }
+                queryNorms[i] = norm;
+                heaps[i].reset(std::min(k_, n));
+            }
+
+            for (size_t begin = 0; begin < n; begin += kReferenceTile) {
+                const size_t width = std::min(n - begin, kReferenceTile);
+                const R* block = nullptr;
+                size_t stride = 0;
+                if (references.isStrided()) {
+                    block = references.rowPtr(begin);
+                    stride = references.stride();
+                } else {
+                    if (referenceBlock.rows() != kReferenceTile) {
+                        referenceBlock = utils::BasicMatrix<R>(kReferenceTile, dims);
+                    }
+                    for (size_t j = 0; j < width; ++j) {
+                        const R* row = references.rowPtr(begin + j);
+                        std::copy(row, row + dims, referenceBlock.rowPtr(j));
+                    }
+                    block = referenceBlock.data();
+                    stride = referenceBlock.stride();
+                }
+
+                utils::gemm(count, width, dims, R(1), queryBlock.data(), queryBlock.stride(),
+                            utils::Transpose::No, block, stride, utils::Transpose::Yes,
+                            R(0), dots.data(), dots.stride());
+
+                for (size_t i = 0; i < count; ++i) {
+                    const R* dot = dots.rowPtr(i);
+                    NeighborHeap& heap = heaps[i];
+                    for (size_t j = 0; j < width; ++j) {
+                        const double distance = queryNorms[i] + referenceNorms[begin + j] - 2.0 * dot[j];
+                        if (!heap.full() || distance <= heap.worst()) {
+                            heap.push(std::max(0.0, distance), begin + j);
+                        }
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                heaps[i].sortedInto(neighbors);
+                visit(first + i, neighbors);
+            }
+        }
+    });
+}
+
+template <typename Q>
+double KNNClassifier::recallDense(const utils::BasicMatrixView<Q>& queries) const {
+    // Trees search exactly and keep their rows in leaf order only
+    const bool exactIndex = storage_ == Storage::Dense ? !dense_.tree.empty() : !denseF_.tree.empty();
+    if (storage_ == Storage::Sparse || queries.rows() == 0 || exactIndex) {
+        return 1.0;
+    }
+
+    std::vector<std::vector<size_t>> exact(queries.rows());
+    std::vector<std::vector<size_t>> found(queries.rows());
+    auto collectInto = [](std::vector<std::vector<size_t>>& out) {
+        return [&out](size_t query, std::vector<Neighbor>& neighbors) {
+            for (const Neighbor& neighbor : neighbors) {
+                out[query].push_back(neighbor.index);
+            }
+            std::sort(out[query].begin(), out[query].end());
+        };
+    };
+    if (storage_ == Storage::Dense) {
+        searchDense(dense_, queries, true, collectInto(exact));
+        searchDense(dense_, queries, false, collectInto(found));
+    } else {
+        searchDense(denseF_, queries, true, collectInto(exact));
+        searchDense(denseF_, queries, false, collectInto(found));
+    }
+
+    double total = 0.0;
+    std::vector<size_t> common;
+    for (size_t i = 0; i < queries.rows(); ++i) {
+        if (exact[i].empty()) {
+            total += 1.0;
+            continue;
+        }
+        common.clear();
+        std::set_intersection(exact[i].begin(), exact[i].end(), found[i].begin(), found[i].end(),
+                              std::back_inserter(common));
+        total += static_cast<double>(common.size()) / static_cast<double>(exact[i].size());
+    }
+    return total / static_cast<double>(queries.rows());
+}
+
+double KNNClassifier::vote(std::vector<Neighbor>& distances) const {
+    const size_t k = std::min(k_, distances.size());
+    std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
 
-    double sum = 0.0;
-    for (size_t i = 0; i < a.size(); ++i) {
-        double diff = a[i] - b[i];
-        sum += diff * diff;
+    std::map<double, int> classVotes;
+    for (size_t j = 0; j < k; ++j) {
+        ++classVotes[trainTargets_[distances[j].index]];
     }
 
-    return std::sqrt(sum);
+    auto maxVote = std::max_element(
+        classVotes.begin(), classVotes.end(),
+        [](const std::pair<double, int>& p1, const std::pair<double, int>& p2) {
+            return p1.second < p2.second;
+        });
+
+    return maxVote->first;
+}
+
+std::vector<double> KNNClassifier::getParameters() const {
+    // KNN doesn't have parameters in the traditional sense
+    return {};
 }
 
 } // namespace models
@@ -1,65 +1,586 @@
 #include "../../include/models/LinearRegression.hpp"
+#include "../../include/utils/Decomposition.hpp"
+#include "../../include/utils/Gemm.hpp"
 #include "../../include/utils/Matrix.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 
 namespace ml {
 namespace models {
 
+namespace {
+
+// Rows per gemm update of X^T X, and per QR update in the fallback
+constexpr size_t kBlockRows = 1024;
+
+// Most O(width^2) partial sums accumulate() keeps; each covers a run of
+// blocks fixed by the row count alone
+constexpr size_t kMaxPartials = 64;
+
+// Cholesky is rejected when some column keeps less than this fraction of
+// its squared norm after projecting out the columns before it (1 - R^2 of
+// that column on the others): the normal equations would then lose about
+// twice as many digits as a QR solve
+constexpr double kMinResidualFraction = 1e-8;
+
+// Smallest 1 - x^T P x accepted when removing a row; anything below means
+// the remaining rows no longer determine the fit
+constexpr double kMinDowndate = 1e-10;
+
+/**
+ * Least squares by QR in O(width^2) memory: the triangular factor of
+ * [X | y] is updated one row block at a time by factoring [R; block].
+ * The last column of R holds Q^T y, so the solution is one back
+ * substitution away.
+ */
+class StreamingQR {
+public:
+    explicit StreamingQR(size_t width) : width_(width), r_(0, width + 1) {}
+
+    /**
+     * @brief Fold in rows of [design | target] (width + 1 columns)
+     */
+    void add(const utils::Matrix& block, size_t rows) {
+        // Zero rows do not change the problem, and keep the stack tall enough to factor
+        utils::Matrix stacked(std::max(r_.rows() + rows, width_ + 1), width_ + 1);
+        for (size_t i = 0; i < r_.rows(); ++i) {
+            std::copy(r_.rowPtr(i), r_.rowPtr(i) + width_ + 1, stacked.rowPtr(i));
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            std::copy(block.rowPtr(i), block.rowPtr(i) + width_ + 1, stacked.rowPtr(r_.rows() + i));
+        }
+        r_ = utils::QRDecomposition(stacked).R();
+    }
+
+    /**
+     * @brief Back substitution; coefficients of columns that are exact
+     *        combinations of earlier ones are set to zero
+     */
+    std::vector<double> solve() const {
+        std::vector<double> coefficients(width_, 0.0);
+        if (r_.rows() == 0) {
+            return coefficients;
+        }
+
+        double largest = 0.0;
+        for (size_t j = 0; j < width_; ++j) {
+            largest = std::max(largest, std::abs(r_(j, j)));
+        }
+        const double cutoff = largest * width_ * std::numeric_limits<double>::epsilon();
+
+        for (size_t j = width_; j-- > 0;) {
+            if (std::abs(r_(j, j)) <= cutoff) {
+                continue;
+            }
+            double sum = r_(j, width_);
+            for (size_t k = j + 1; k < width_; ++k) {
+                sum -= r_(j, k) * coefficients[k];
+            }
+            coefficients[j] = sum / r_(j, j);
+        }
+        return coefficients;
+    }
+
+private:
+    size_t width_;
+    utils::Matrix r_;
+};
+
+// Copy rows [begin, begin + count) of [1, x, y] (intercept column optional)
+template <typename T>
+void fillDesign(const utils::BasicMatrixView<T>& features, utils::Span<const double> targets,
+                size_t begin, size_t count, bool intercept, utils::Matrix& block) {
+    const size_t offset = intercept ? 1 : 0;
+    const size_t cols = features.cols();
+    for (size_t i = 0; i < count; ++i) {
+        const T* row = features.rowPtr(begin + i);
+        double* out = block.rowPtr(i);
+        if (intercept) {
+            out[0] = 1.0;
+        }
+        std::copy(row, row + cols, out + offset);
+        out[offset + cols] = targets[begin + i];
+    }
+}
+
+template <typename T>
+std::vector<double> solveByQR(const utils::BasicMatrixView<T>& features,
+                              utils::Span<const double> targets, bool intercept) {
+    const size_t width = features.cols() + (intercept ? 1 : 0);
+    StreamingQR qr(width);
+    utils::Matrix block(std::min(kBlockRows, features.rows()), width + 1);
+    for (size_t begin = 0; begin < features.rows(); begin += kBlockRows) {
+        const size_t count = std::min(kBlockRows, features.rows() - begin);
+        fillDesign(features, targets, begin, count, intercept, block);
+        qr.add(block, count);
+    }
+    return qr.solve();
+}
+
+} // namespace
+
 LinearRegression::LinearRegression(bool fitIntercept)
     : fitIntercept_(fitIntercept) {}
 
-bool LinearRegression::train(const utils::Matrix& features,
+bool LinearRegression::train(const utils::MatrixView& features,
+                             const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+bool LinearRegression::train(const utils::MatrixViewF& features,
                              const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+std::vector<double> LinearRegression::predict(const utils::MatrixView& features) const {
+    return predictRows(features);
+}
+
+std::vector<double> LinearRegression::predict(const utils::MatrixViewF& features) const {
+    return predictRows(features);
+}
+
+void LinearRegression::partialFit(const utils::MatrixView& features,
+                                  const std::vector<double>& targets) {
+    update(features, targets, 1.0);
+}
+
+void LinearRegression::partialFit(const utils::MatrixViewF& features,
+                                  const std::vector<double>& targets) {
+    update(features, targets, 1.0);
+}
+
+void LinearRegression::removeRows(const utils::MatrixView& features,
+                                  const std::vector<double>& targets) {
+    update(features, targets, -1.0);
+}
+
+void LinearRegression::removeRows(const utils::MatrixViewF& features,
+                                  const std::vector<double>& targets) {
+    update(features, targets, -1.0);
+}
+
+void LinearRegression::setForgettingFactor(double lambda) {
+    if (!(lambda > 0.0 && lambda <= 1.0)) {
+        throw std::invalid_argument("Forgetting factor must be in (0, 1]");
+    }
+    forgetting_ = lambda;
+}
+
+template <typename T>
+bool LinearRegression::fit(const utils::BasicMatrixView<T>& features,
+                           const std::vector<double>& targets) {
     if (features.rows() != targets.size()) {
         throw std::invalid_argument("Number of samples in features and targets must match");
     }
 
-    utils::Matrix X = features;
-    if (fitIntercept_) {
-        X = utils::Matrix::ones(features.rows(), features.cols() + 1);
-        for (size_t i = 0; i < features.rows(); ++i) {
-            for (size_t j = 0; j < features.cols(); ++j) {
-                X[i][j + 1] = features[i][j];
+    const size_t width = features.cols() + (fitIntercept_ ? 1 : 0);
+    utils::Matrix gram(width, width);
+    std::vector<double> moments(width, 0.0);
+    accumulate(features, targets, gram, moments);
+
+    const bool solved = solveNormalEquations(gram, moments);
+    if (!solved) {
+        coefficients_ = solveByQR(features, targets, fitIntercept_);
+    }
+    resetOnline(std::move(gram), std::move(moments), solved);
+    return true;
+}
+
+template <typename T>
+void LinearRegression::accumulate(const utils::BasicMatrixView<T>& features,
+                                  utils::Span<const double> targets,
+                                  utils::Matrix& gram, std::vector<double>& moments) const {
+    const size_t rows = features.rows();
+    const size_t cols = features.cols();
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t width = cols + offset;
+    const size_t blocks = (rows + kBlockRows - 1) / kBlockRows;
+
+    // Each partial sums its own fixed run of blocks into its slot (width x
+    // width of X^T X, then width of X^T y); the slots are then added in
+    // order, so the result does not depend on the thread count
+    const size_t partialCount = std::min(blocks, kMaxPartials);
+    const size_t blocksPerPartial = partialCount > 0 ? (blocks + partialCount - 1) / partialCount : 0;
+    const size_t slot = width * width + width;
+    std::vector<double> partials(partialCount * slot, 0.0);
+
+    utils::parallelFor(0, partialCount, 1, [&](size_t lo, size_t hi) {
+        // Partials are the unit of parallelism; keep their gemms on this thread
+        utils::ThreadLimit serial(1);
+        utils::Matrix block;
+
+        for (size_t p = lo; p < hi; ++p) {
+            double* localGram = partials.data() + p * slot;
+            double* localMoments = localGram + width * width;
+            const size_t lastBlock = std::min(blocks, (p + 1) * blocksPerPartial);
+            for (size_t b = p * blocksPerPartial; b < lastBlock; ++b) {
+                const size_t begin = b * kBlockRows;
+                const size_t count = std::min(kBlockRows, rows - begin);
+
+                // Evenly strided double rows feed gemm in place; anything else is packed
+                const double* data = nullptr;
+                size_t ld = 0;
+                if constexpr (std::is_same<T, double>::value) {
+                    if (features.isStrided()) {
+                        data = features.rowPtr(begin);
+                        ld = features.stride();
+                    }
+                }
+                if (!data) {
+                    if (block.rows() != count) {
+                        block = utils::Matrix(count, cols);
+                    }
+                    for (size_t i = 0; i < count; ++i) {
+                        const T* row = features.rowPtr(begin + i);
+                        std::copy(row, row + cols, block.rowPtr(i));
+                    }
+                    data = block.data();
+                    ld = block.stride();
+                }
+
+                // Intercept row/column (column sums) and X^T y in one sweep
+                for (size_t i = 0; i < count; ++i) {
+                    const double* row = data + i * ld;
+                    const double y = targets[begin + i];
+                    if (fitIntercept_) {
+                        localMoments[0] += y;
+                        double* sums = localGram + 1;
+                        for (size_t j = 0; j < cols; ++j) {
+                            sums[j] += row[j];
+                        }
+                    }
+                    double* xy = localMoments + offset;
+                    for (size_t j = 0; j < cols; ++j) {
+                        xy[j] += y * row[j];
+                    }
+                }
+                utils::gemm(cols, cols, count, 1.0, data, ld, utils::Transpose::Yes,
+                            data, ld, utils::Transpose::No, 1.0,
+                            localGram + offset * width + offset, width);
             }
         }
+    });
+
+    for (size_t p = 0; p < partialCount; ++p) {
+        const double* localGram = partials.data() + p * slot;
+        const double* localMoments = localGram + width * width;
+        for (size_t i = 0; i < width; ++i) {
+            double* to = gram.rowPtr(i);
+            for (size_t j = 0; j < width; ++j) {
+                to[j] += localGram[i * width + j];
+            }
+            moments[i] += localMoments[i];
+        }
     }
 
-    utils::Matrix y(targets.size(), 1);
-    for (size_t i = 0; i < targets.size(); ++i) {
-        y[i][0] = targets[i];
+    // Only the first row of the intercept block was summed; mirror it
+    if (fitIntercept_) {
+        gram(0, 0) += static_cast<double>(rows);
+        for (size_t j = 1; j < width; ++j) {
+            gram(j, 0) = gram(0, j);
+        }
     }
+}
 
-    utils::Matrix X_T = X.transpose();
-    utils::Matrix X_T_X = X_T * X;
-    utils::Matrix X_T_X_inv = X_T_X.inverse();
-    utils::Matrix X_T_y = X_T * y;
+bool LinearRegression::train(const utils::SparseMatrix& features,
+                             const std::vector<double>& targets) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
 
-    utils::Matrix theta = X_T_X_inv * X_T_y;
+    // X^T X and X^T y from the nonzeros only; the intercept column of ones
+    // contributes the sample count, the column sums and the target sum
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t p = features.cols() + offset;
+    const utils::Matrix gram = features.gram();
+    const utils::SparseMatrix csc = features.toCSC();
 
-    coefficients_.resize(theta.rows());
-    for (size_t i = 0; i < theta.rows(); ++i) {
-        coefficients_[i] = theta[i][0];
+    utils::Matrix X_T_X(p, p);
+    std::vector<double> X_T_y(p, 0.0);
+    for (size_t a = 0; a < features.cols(); ++a) {
+        std::copy(gram.rowPtr(a), gram.rowPtr(a) + features.cols(), X_T_X.rowPtr(a + offset) + offset);
+
+        utils::Span<const size_t> rows = csc.innerIndices(a);
+        utils::Span<const double> values = csc.innerValues(a);
+        double columnSum = 0.0;
+        double columnDot = 0.0;
+        for (size_t k = 0; k < rows.size(); ++k) {
+            columnSum += values[k];
+            columnDot += values[k] * targets[rows[k]];
+        }
+        X_T_y[a + offset] = columnDot;
+        if (fitIntercept_) {
+            X_T_X(0, a + 1) = columnSum;
+            X_T_X(a + 1, 0) = columnSum;
+        }
+    }
+    if (fitIntercept_) {
+        X_T_X(0, 0) = static_cast<double>(features.rows());
+        double targetSum = 0.0;
+        for (double t : targets) {
+            targetSum += t;
+        }
+        X_T_y[0] = targetSum;
+    }
+
+    const bool solved = solveNormalEquations(X_T_X, X_T_y);
+    if (!solved) {
+        // Densify one row block at a time for the QR pass
+        const utils::SparseMatrix csr = features.toCSR();
+        StreamingQR qr(p);
+        utils::Matrix block(std::min(kBlockRows, csr.rows()), p + 1);
+        for (size_t begin = 0; begin < csr.rows(); begin += kBlockRows) {
+            const size_t count = std::min(kBlockRows, csr.rows() - begin);
+            for (size_t i = 0; i < count; ++i) {
+                double* out = block.rowPtr(i);
+                std::fill(out, out + p + 1, 0.0);
+                if (fitIntercept_) {
+                    out[0] = 1.0;
+                }
+                utils::Span<const size_t> columns = csr.innerIndices(begin + i);
+                utils::Span<const double> values = csr.innerValues(begin + i);
+                for (size_t k = 0; k < columns.size(); ++k) {
+                    out[columns[k] + offset] = values[k];
+                }
+                out[p] = targets[begin + i];
+            }
+            qr.add(block, count);
+        }
+        coefficients_ = qr.solve();
+    }
+    resetOnline(std::move(X_T_X), std::move(X_T_y), solved);
+    return true;
+}
+
+bool LinearRegression::train(data::BatchSource& source) {
+    const size_t width = source.cols() + (fitIntercept_ ? 1 : 0);
+    utils::Matrix gram(width, width);
+    std::vector<double> moments(width, 0.0);
+
+    data::Batch batch;
+    size_t samples = 0;
+    source.reset();
+    while (source.next(batch)) {
+        accumulate(utils::MatrixView(batch.features), batch.targets, gram, moments);
+        samples += batch.rows();
+    }
+
+    if (samples == 0) {
+        return false;
     }
 
+    const bool solved = solveNormalEquations(gram, moments);
+    if (!solved) {
+        // Second pass over the source for the QR solve
+        StreamingQR qr(width);
+        utils::Matrix block;
+        source.reset();
+        while (source.next(batch)) {
+            if (block.rows() < batch.rows()) {
+                block = utils::Matrix(batch.rows(), width + 1);
+            }
+            fillDesign(utils::MatrixView(batch.features), batch.targets, 0, batch.rows(),
+                       fitIntercept_, block);
+            qr.add(block, batch.rows());
+        }
+        coefficients_ = qr.solve();
+    }
+    resetOnline(std::move(gram), std::move(moments), solved);
     return true;
 }
 
-std::vector<double> LinearRegression::predict(const utils::Matrix& features) const {
-    utils::Matrix X = features;
+std::vector<double> LinearRegression::predict(const utils::SparseMatrix& features) const {
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    if (coefficients_.size() != features.cols() + offset) {
+        throw std::invalid_argument("Feature count does not match the trained model");
+    }
+
+    std::vector<double> predictions = features.multiply(
+        utils::Span<const double>(coefficients_.data() + offset, features.cols()));
     if (fitIntercept_) {
-        X = utils::Matrix::ones(features.rows(), features.cols() + 1);
-        for (size_t i = 0; i < features.rows(); ++i) {
-            for (size_t j = 0; j < features.cols(); ++j) {
-                X[i][j + 1] = features[i][j];
+        for (double& prediction : predictions) {
+            prediction += coefficients_[0];
+        }
+    }
+    return predictions;
+}
+
+bool LinearRegression::solveNormalEquations(const utils::Matrix& gram,
+                                            const std::vector<double>& moments) {
+    utils::CholeskyDecomposition cholesky(gram);
+    if (!cholesky.isPositiveDefinite()) {
+        return false;
+    }
+
+    // L_jj^2 is what remains of column j's squared norm once the earlier
+    // columns are projected out, so the ratio is scale-free
+    const utils::Matrix L = cholesky.L();
+    for (size_t j = 0; j < gram.rows(); ++j) {
+        if (L(j, j) * L(j, j) < kMinResidualFraction * gram(j, j)) {
+            return false;
+        }
+    }
+
+    coefficients_ = cholesky.solve(moments);
+    return true;
+}
+
+void LinearRegression::resetOnline(utils::Matrix gram, std::vector<double> moments, bool solved) {
+    gram_ = std::move(gram);
+    // A rank-deficient fit keeps its QR coefficients while updates
+    // accumulate towards a determined system, as on an untrained model
+    moments_ = solved ? std::vector<double>() : std::move(moments);
+    inverse_ = utils::Matrix();
+    pending_ = !solved;
+    inverseReady_ = false;
+}
+
+template <typename T>
+void LinearRegression::update(const utils::BasicMatrixView<T>& features,
+                              const std::vector<double>& targets, double sign) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
+    if (sign < 0.0 && forgetting_ != 1.0) {
+        throw std::runtime_error("Row removal requires a forgetting factor of 1");
+    }
+
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t cols = features.cols();
+    const size_t width = cols + offset;
+    if (coefficients_.empty() && !pending_) {
+        if (sign < 0.0) {
+            throw std::runtime_error("Cannot remove rows from an untrained model");
+        }
+        gram_ = utils::Matrix(width, width);
+        moments_.assign(width, 0.0);
+        inverse_ = utils::Matrix();
+        pending_ = true;
+        inverseReady_ = false;
+    }
+    if ((inverseReady_ ? inverse_.rows() : gram_.rows()) != width) {
+        throw std::invalid_argument("Feature count does not match the trained model");
+    }
+
+    if (pending_) {
+        // Not yet determined: keep accumulating statistics and retry the solve
+        if (forgetting_ < 1.0) {
+            // Every row ages on its own (row r of n ends up weighted
+            // lambda^(n - 1 - r)), so fold them in one at a time as RLS does
+            std::vector<double> x(width);
+            for (size_t r = 0; r < features.rows(); ++r) {
+                const T* row = features.rowPtr(r);
+                if (fitIntercept_) {
+                    x[0] = 1.0;
+                }
+                std::copy(row, row + cols, x.data() + offset);
+                for (size_t i = 0; i < width; ++i) {
+                    double* g = gram_.rowPtr(i);
+                    for (size_t j = 0; j < width; ++j) {
+                        g[j] = forgetting_ * g[j] + x[i] * x[j];
+                    }
+                    moments_[i] = forgetting_ * moments_[i] + x[i] * targets[r];
+                }
+            }
+        } else {
+            utils::Matrix gram(width, width);
+            std::vector<double> moments(width, 0.0);
+            accumulate(features, targets, gram, moments);
+            for (size_t i = 0; i < width; ++i) {
+                for (size_t j = 0; j < width; ++j) {
+                    gram_(i, j) += sign * gram(i, j);
+                }
+                moments_[i] += sign * moments[i];
+            }
+        }
+        if (solveNormalEquations(gram_, moments_)) {
+            pending_ = false;
+            moments_.clear();
+        }
+        return;
+    }
+
+    if (!inverseReady_) {
+        utils::CholeskyDecomposition cholesky(gram_);
+        if (!cholesky.isPositiveDefinite()) {
+            throw std::runtime_error("The fitted rows do not determine the inverse needed for updates");
+        }
+        inverse_ = cholesky.inverse();
+        inverseReady_ = true;
+        gram_ = utils::Matrix();
+    }
+
+    // Sherman-Morrison on P = (X^T X)^-1 for each row x:
+    //   adding:   P' = (P - P x x^T P / (lambda + x^T P x)) / lambda
+    //   removing: P' = P + P x x^T P / (1 - x^T P x)
+    // and the coefficients move by +-(P x / denominator) times the residual
+    const double lambda = sign > 0.0 ? forgetting_ : 1.0;
+    std::vector<double> x(width);
+    std::vector<double> Px(width);
+    for (size_t r = 0; r < features.rows(); ++r) {
+        const T* row = features.rowPtr(r);
+        if (fitIntercept_) {
+            x[0] = 1.0;
+        }
+        std::copy(row, row + cols, x.data() + offset);
+
+        double quadratic = 0.0;
+        double residual = targets[r];
+        for (size_t i = 0; i < width; ++i) {
+            const double* p = inverse_.rowPtr(i);
+            double sum = 0.0;
+            for (size_t j = 0; j < width; ++j) {
+                sum += p[j] * x[j];
             }
+            Px[i] = sum;
+            quadratic += x[i] * sum;
+            residual -= x[i] * coefficients_[i];
+        }
+
+        const double denominator = lambda + sign * quadratic;
+        if (denominator <= kMinDowndate) {
+            throw std::runtime_error("Removing these rows leaves the fit underdetermined");
+        }
+        const double scale = sign / denominator;
+        for (size_t i = 0; i < width; ++i) {
+            coefficients_[i] += scale * Px[i] * residual;
         }
+
+        // Update the upper triangle and mirror it so P stays exactly symmetric
+        const double invLambda = 1.0 / lambda;
+        for (size_t i = 0; i < width; ++i) {
+            double* p = inverse_.rowPtr(i);
+            const double a = scale * Px[i];
+            for (size_t j = i; j < width; ++j) {
+                p[j] = (p[j] - a * Px[j]) * invLambda;
+            }
+        }
+        for (size_t i = 1; i < width; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                inverse_(i, j) = inverse_(j, i);
+            }
+        }
+    }
+}
+
+template <typename T>
+std::vector<double> LinearRegression::predictRows(const utils::BasicMatrixView<T>& features) const {
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    if (coefficients_.size() != features.cols() + offset) {
+        throw std::invalid_argument("Feature count does not match the trained model");
     }
 
-    std::vector<double> predictions(X.rows());
-    for (size_t i = 0; i < X.rows(); ++i) {
-        double prediction = 0.0;
-        for (size_t j = 0; j < X.cols(); ++j) {
-            prediction += X[i][j] * coefficients_[j];
+    std::vector<double> predictions(features.rows());
+    for (size_t i = 0; i < features.rows(); ++i) {
+        const T* row = features.rowPtr(i);
+        double prediction = fitIntercept_ ? coefficients_[0] : 0.0;
+        for (size_t j = 0; j < features.cols(); ++j) {
+            prediction += row[j] * coefficients_[j + offset];
         }
         predictions[i] = prediction;
     }
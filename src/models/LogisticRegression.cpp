@@ -1,82 +1,663 @@
 #include "../../include/models/LogisticRegression.hpp"
+#include "../../include/models/GradientTraining.hpp"
 #include "../../include/utils/Matrix.hpp"
+#include "../../include/utils/Decomposition.hpp"
+#include "../../include/utils/Gemm.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include "../../include/utils/Timer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <mutex>
+#include <numeric>
+#include <random>
 #include <stdexcept>
-#include <algorithm>
 
 namespace ml {
 namespace models {
 
+namespace {
+
+// Rows per gemm update of the Newton Hessian
+constexpr size_t kBlockRows = 256;
+
+// Rows each thread takes at a time in Hogwild training
+constexpr size_t kHogwildGrain = 1024;
+
+// L-BFGS curvature pairs kept
+constexpr size_t kHistory = 10;
+
+// Second-order solvers stop once an iteration changes the loss by less than
+// this fraction of it
+constexpr double kRelativeLossChange = 1e-12;
+
+// Sufficient-decrease constant and step halvings of the line search
+constexpr double kArmijo = 1e-4;
+constexpr size_t kMaxLineSearchSteps = 40;
+
+// Added to the Newton Hessian's diagonal
+constexpr double kHessianRidge = 1e-10;
+
+double dot(const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for (size_t j = 0; j < a.size(); ++j) {
+        sum += a[j] * b[j];
+    }
+    return sum;
+}
+
+// y += a * x
+void axpy(double a, const std::vector<double>& x, std::vector<double>& y) {
+    for (size_t j = 0; j < x.size(); ++j) {
+        y[j] += a * x[j];
+    }
+}
+
+// Log-loss of one row from its score z, storing the predicted probability.
+// The stable form log(1 + e^-|z|) never overflows, and the probability never
+// rounds to exactly 0 or 1 inside a logarithm
+inline double rowLoss(double z, double target, double& probability) {
+    const double e = std::exp(-std::abs(z));
+    probability = z >= 0 ? 1.0 / (1.0 + e) : e / (1.0 + e);
+    return std::max(z, 0.0) - target * z + std::log1p(e);
+}
+
+} // namespace
+
 LogisticRegression::LogisticRegression(double learningRate, size_t maxIterations,
                                        double tolerance, bool fitIntercept)
     : learningRate_(learningRate), maxIterations_(maxIterations),
       tolerance_(tolerance), fitIntercept_(fitIntercept) {}
 
-bool LogisticRegression::train(const utils::Matrix& features,
+void LogisticRegression::setOptimizer(std::shared_ptr<Optimizer> optimizer,
+                                      MiniBatchOptions options) {
+    validateMiniBatchOptions(options);
+    optimizer_ = std::move(optimizer);
+    miniBatch_ = options;
+}
+
+bool LogisticRegression::train(const utils::MatrixView& features,
+                               const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+bool LogisticRegression::train(const utils::MatrixViewF& features,
                                const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+std::vector<double> LogisticRegression::predict(const utils::MatrixView& features) const {
+    return predictRows(features);
+}
+
+std::vector<double> LogisticRegression::predict(const utils::MatrixViewF& features) const {
+    return predictRows(features);
+}
+
+template <typename T>
+bool LogisticRegression::fit(const utils::BasicMatrixView<T>& features,
+                             const std::vector<double>& targets) {
     if (features.rows() != targets.size()) {
         throw std::invalid_argument("Number of samples in features and targets must match");
     }
 
-    utils::Matrix X = features;
-    if (fitIntercept_) {
-        X = utils::Matrix::ones(features.rows(), features.cols() + 1);
-        for (size_t i = 0; i < features.rows(); ++i) {
-            for (size_t j = 0; j < features.cols(); ++j) {
-                X[i][j + 1] = features[i][j];
+    const auto start = std::chrono::steady_clock::now();
+    stats_ = SolveStats();
+    coefficients_.assign(features.cols() + (fitIntercept_ ? 1 : 0), 0.0);
+    if (optimizer_) {
+        fitMiniBatch(features, targets);
+    } else {
+        switch (solver_) {
+            case LogisticSolver::LBFGS:
+                fitLBFGS(features, targets);
+                break;
+            case LogisticSolver::Newton:
+                fitNewton(features, targets);
+                break;
+            case LogisticSolver::GradientDescent:
+            default:
+                fitGradientDescent(features, targets);
+                break;
+        }
+    }
+    stats_.seconds = utils::secondsSince(start);
+
+    return true;
+}
+
+template <typename T>
+void LogisticRegression::fitGradientDescent(const utils::BasicMatrixView<T>& features,
+                                            const std::vector<double>& targets) {
+    // Scratch lives in members, so once a fit of this shape has run, later
+    // fits (and every iteration) reuse it instead of allocating
+    gradient_.assign(coefficients_.size(), 0.0);
+
+    for (size_t iteration = 0; iteration < maxIterations_; ++iteration) {
+        // The cost of the current iterate decides convergence before the step
+        stats_.loss = lossAndGradient(features, targets, 0, features.rows(), gradient_, partials_);
+        stats_.gradientNorm = maxAbs(gradient_);
+        if (iteration > 0 && stats_.loss < tolerance_) {
+            stats_.converged = true;
+            break;
+        }
+
+        for (size_t j = 0; j < gradient_.size(); ++j) {
+            coefficients_[j] -= learningRate_ * gradient_[j];
+        }
+        stats_.iterations = iteration + 1;
+    }
+}
+
+template <typename T>
+void LogisticRegression::fitLBFGS(const utils::BasicMatrixView<T>& features,
+                                  const std::vector<double>& targets) {
+    const size_t width = coefficients_.size();
+    std::vector<double> gradient(width);
+    std::vector<double> partials;
+    double loss = lossAndGradient(features, targets, 0, features.rows(), gradient, partials);
+
+    // Ring buffer of the last kHistory steps s = w' - w and gradient changes y = g' - g
+    std::vector<std::vector<double>> s(kHistory, std::vector<double>(width));
+    std::vector<std::vector<double>> y(kHistory, std::vector<double>(width));
+    std::vector<double> rho(kHistory);
+    std::vector<double> alpha(kHistory);
+    size_t stored = 0;
+    size_t newest = 0;
+
+    std::vector<double> direction(width);
+    std::vector<double> previous(width);
+    std::vector<double> previousGradient(width);
+    std::vector<double> stepTaken(width);
+    std::vector<double> gradientChange(width);
+
+    for (size_t iteration = 0; iteration < maxIterations_; ++iteration) {
+        if (maxAbs(gradient) <= tolerance_) {
+            stats_.converged = true;
+            break;
+        }
+
+        // Two-loop recursion: direction = -H * gradient for the implicit inverse Hessian H
+        for (size_t j = 0; j < width; ++j) {
+            direction[j] = -gradient[j];
+        }
+        for (size_t h = 0; h < stored; ++h) {
+            const size_t k = (newest + kHistory - h) % kHistory;
+            alpha[k] = rho[k] * dot(s[k], direction);
+            axpy(-alpha[k], y[k], direction);
+        }
+        if (stored > 0) {
+            const double gamma = dot(s[newest], y[newest]) / dot(y[newest], y[newest]);
+            for (double& d : direction) {
+                d *= gamma;
+            }
+        }
+        for (size_t h = stored; h-- > 0;) {
+            const size_t k = (newest + kHistory - h) % kHistory;
+            const double beta = rho[k] * dot(y[k], direction);
+            axpy(alpha[k] - beta, s[k], direction);
+        }
+
+        // Without curvature information, take a step of unit length
+        double step = stored > 0 ? 1.0 : 1.0 / std::max(1.0, std::sqrt(dot(gradient, gradient)));
+        if (dot(direction, gradient) >= 0.0) {
+            // The history stopped describing a descent direction; start over
+            for (size_t j = 0; j < width; ++j) {
+                direction[j] = -gradient[j];
             }
+            stored = 0;
+            step = 1.0 / std::max(1.0, std::sqrt(dot(gradient, gradient)));
+        }
+
+        previous = coefficients_;
+        previousGradient = gradient;
+        const double previousLoss = loss;
+        if (!lineSearch(features, targets, direction, step, loss, gradient, partials)) {
+            break;
+        }
+        stats_.iterations = iteration + 1;
+
+        for (size_t j = 0; j < width; ++j) {
+            stepTaken[j] = coefficients_[j] - previous[j];
+            gradientChange[j] = gradient[j] - previousGradient[j];
+        }
+        // Keep the pair only if it has positive curvature, so H stays positive
+        // definite; a full ring only gives up its oldest pair once one is kept
+        const double curvature = dot(stepTaken, gradientChange);
+        if (curvature > 1e-10 * dot(gradientChange, gradientChange)) {
+            const size_t next = stored == 0 ? 0 : (newest + 1) % kHistory;
+            s[next].swap(stepTaken);
+            y[next].swap(gradientChange);
+            rho[next] = 1.0 / curvature;
+            newest = next;
+            stored = std::min(stored + 1, kHistory);
+        }
+
+        if (std::abs(previousLoss - loss) <= kRelativeLossChange * std::max(1.0, std::abs(loss))) {
+            stats_.converged = true;
+            break;
         }
     }
 
-    coefficients_ = std::vector<double>(X.cols(), 0.0);
+    stats_.loss = loss;
+    stats_.gradientNorm = maxAbs(gradient);
+    stats_.converged = stats_.converged || stats_.gradientNorm <= tolerance_;
+}
+
+template <typename T>
+void LogisticRegression::fitNewton(const utils::BasicMatrixView<T>& features,
+                                   const std::vector<double>& targets) {
+    const size_t width = coefficients_.size();
+    std::vector<double> gradient(width);
+    std::vector<double> partials;
+    double loss = lossAndGradient(features, targets, 0, features.rows(), gradient, partials);
 
     for (size_t iteration = 0; iteration < maxIterations_; ++iteration) {
-        std::vector<double> predictions = predict(features);
-        
-        std::vector<double> gradient(X.cols(), 0.0);
-        for (size_t i = 0; i < X.rows(); ++i) {
-            double error = predictions[i] - targets[i];
-            for (size_t j = 0; j < X.cols(); ++j) {
-                gradient[j] += error * X[i][j];
+        if (maxAbs(gradient) <= tolerance_) {
+            stats_.converged = true;
+            break;
+        }
+
+        // A tiny ridge keeps the system solvable when the classes are
+        // (nearly) separable and the Hessian loses rank
+        utils::Matrix H = hessian(features);
+        for (size_t j = 0; j < width; ++j) {
+            H[j][j] += kHessianRidge;
+        }
+        // Fall back to steepest descent if the factorization still fails
+        utils::CholeskyDecomposition cholesky(H);
+        std::vector<double> direction = cholesky.isPositiveDefinite() ? cholesky.solve(gradient)
+                                                                       : gradient;
+        for (double& d : direction) {
+            d = -d;
+        }
+
+        const double previousLoss = loss;
+        if (!lineSearch(features, targets, direction, 1.0, loss, gradient, partials)) {
+            break;
+        }
+        stats_.iterations = iteration + 1;
+
+        if (std::abs(previousLoss - loss) <= kRelativeLossChange * std::max(1.0, std::abs(loss))) {
+            stats_.converged = true;
+            break;
+        }
+    }
+
+    stats_.loss = loss;
+    stats_.gradientNorm = maxAbs(gradient);
+    stats_.converged = stats_.converged || stats_.gradientNorm <= tolerance_;
+}
+
+template <typename T>
+bool LogisticRegression::lineSearch(const utils::BasicMatrixView<T>& features,
+                                    const std::vector<double>& targets,
+                                    const std::vector<double>& direction, double step,
+                                    double& loss, std::vector<double>& gradient,
+                                    std::vector<double>& partials) {
+    const std::vector<double> start = coefficients_;
+    const double slope = dot(direction, gradient);
+    std::vector<double> trialGradient(gradient.size());
+
+    for (size_t attempt = 0; attempt < kMaxLineSearchSteps; ++attempt, step *= 0.5) {
+        for (size_t j = 0; j < start.size(); ++j) {
+            coefficients_[j] = start[j] + step * direction[j];
+        }
+        const double trialLoss = lossAndGradient(features, targets, 0, features.rows(),
+                                                 trialGradient, partials);
+        if (trialLoss <= loss + kArmijo * step * slope) {
+            loss = trialLoss;
+            gradient.swap(trialGradient);
+            return true;
+        }
+    }
+
+    coefficients_ = start;
+    return false;
+}
+
+template <typename T>
+utils::Matrix LogisticRegression::hessian(const utils::BasicMatrixView<T>& features) const {
+    const size_t rows = features.rows();
+    const size_t cols = features.cols();
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t width = cols + offset;
+    const double intercept = fitIntercept_ ? coefficients_[0] : 0.0;
+    const double* weights = coefficients_.data() + offset;
+
+    // Accumulate B^T B over blocks whose rows are sqrt(p (1 - p)) * [1, x];
+    // each block product goes through gemm
+    utils::Matrix H(width, width);
+    utils::Matrix block(std::min(rows, kBlockRows), width);
+    for (size_t begin = 0; begin < rows; begin += kBlockRows) {
+        const size_t count = std::min(kBlockRows, rows - begin);
+        for (size_t i = 0; i < count; ++i) {
+            const T* row = features.rowPtr(begin + i);
+            double z = intercept;
+            for (size_t j = 0; j < cols; ++j) {
+                z += row[j] * weights[j];
+            }
+            const double p = sigmoid(z);
+            const double w = std::sqrt(p * (1.0 - p));
+            double* out = block.rowPtr(i);
+            if (fitIntercept_) {
+                out[0] = w;
+            }
+            for (size_t j = 0; j < cols; ++j) {
+                out[j + offset] = w * row[j];
             }
         }
+        utils::gemm(width, width, count, 1.0, block.data(), width, utils::Transpose::Yes,
+                    block.data(), width, utils::Transpose::No, 1.0, H.data(), width);
+    }
+
+    const double scale = rows > 0 ? 1.0 / static_cast<double>(rows) : 0.0;
+    for (size_t i = 0; i < width; ++i) {
+        for (size_t j = 0; j < width; ++j) {
+            H[i][j] *= scale;
+        }
+    }
+    return H;
+}
+
+template <typename T>
+void LogisticRegression::fitMiniBatch(const utils::BasicMatrixView<T>& features,
+                                      const std::vector<double>& targets) {
+    // One gathered view per epoch; batches are then contiguous row ranges of it
+    utils::BasicMatrixView<T> rows = features;
+    utils::Span<const double> rowTargets(targets);
+    std::vector<double> shuffledTargets;
+    std::vector<double> partials;
+
+    const MiniBatchRun run = runMiniBatches(
+        features.rows(), miniBatch_, tolerance_, *optimizer_, coefficients_,
+        [&](const std::vector<size_t>& order) {
+            rows = features.selectRows(order);
+            shuffledTargets = utils::gather(targets, order);
+            rowTargets = utils::Span<const double>(shuffledTargets);
+        },
+        [&](size_t begin, size_t end, std::vector<double>& gradient) {
+            return lossAndGradient(rows, rowTargets, begin, end, gradient, partials);
+        });
+    stats_.iterations = run.epochs;
+    stats_.loss = run.loss;
+    stats_.converged = run.converged;
+}
+
+bool LogisticRegression::train(const utils::SparseMatrix& features,
+                               const std::vector<double>& targets) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    stats_ = SolveStats();
+    if (optimizer_) {
+        const utils::SparseMatrix X = features.toCSR();
+        if (miniBatch_.hogwild) {
+            fitHogwild(X, targets);
+        } else {
+            fitMiniBatch(X, targets);
+        }
+        stats_.seconds = utils::secondsSince(start);
+        return true;
+    }
+
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t n = features.rows();
+    const utils::SparseMatrix X = features.toCSR();
+    // CSC view of X^T, so X^T * r scatters over X's rows without a conversion
+    const utils::SparseMatrix X_T = X.transpose();
+
+    coefficients_.assign(X.cols() + offset, 0.0);
+    const utils::Span<const double> weights(coefficients_.data() + offset, X.cols());
+    std::vector<double> scores(n);
+    std::vector<double> errors(n);
+    std::vector<double> gradient(coefficients_.size());
+    const utils::Span<double> weightGradient(gradient.data() + offset, X.cols());
+    const double scale = n > 0 ? 1.0 / static_cast<double>(n) : 0.0;
+
+    for (size_t iteration = 0; iteration < maxIterations_; ++iteration) {
+        X.multiply(weights, scores);
+        const double intercept = fitIntercept_ ? coefficients_[0] : 0.0;
+        double cost = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double probability;
+            cost += rowLoss(scores[i] + intercept, targets[i], probability);
+            errors[i] = probability - targets[i];
+        }
 
-        for (size_t j = 0; j < X.cols(); ++j) {
-            coefficients_[j] -= learningRate_ * gradient[j] / X.rows();
+        X_T.multiply(errors, weightGradient);
+        if (fitIntercept_) {
+            double errorSum = 0.0;
+            for (double e : errors) {
+                errorSum += e;
+            }
+            gradient[0] = errorSum;
+        }
+        for (double& g : gradient) {
+            g *= scale;
         }
 
-        double cost = computeCost(X, targets);
-        if (cost < tolerance_) {
+        // The cost of the current iterate decides convergence before the step
+        stats_.loss = cost * scale;
+        stats_.gradientNorm = maxAbs(gradient);
+        if (iteration > 0 && stats_.loss < tolerance_) {
+            stats_.converged = true;
             break;
         }
+
+        for (size_t j = 0; j < gradient.size(); ++j) {
+            coefficients_[j] -= learningRate_ * gradient[j];
+        }
+        stats_.iterations = iteration + 1;
     }
+    stats_.seconds = utils::secondsSince(start);
 
     return true;
 }
 
-std::vector<double> LogisticRegression::predict(const utils::Matrix& features) const {
-    utils::Matrix X = features;
-    if (fitIntercept_) {
-        X = utils::Matrix::ones(features.rows(), features.cols() + 1);
-        for (size_t i = 0; i < features.rows(); ++i) {
-            for (size_t j = 0; j < features.cols(); ++j) {
-                X[i][j + 1] = features[i][j];
+bool LogisticRegression::fitMiniBatch(const utils::SparseMatrix& features,
+                                      const std::vector<double>& targets) {
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    coefficients_ = std::vector<double>(features.cols() + offset, 0.0);
+
+    std::vector<size_t> order(features.rows());
+    std::iota(order.begin(), order.end(), 0);
+    const MiniBatchRun run = runMiniBatches(
+        features.rows(), miniBatch_, tolerance_, *optimizer_, coefficients_,
+        [&](const std::vector<size_t>& shuffled) { order = shuffled; },
+        [&](size_t begin, size_t end, std::vector<double>& gradient) {
+            std::fill(gradient.begin(), gradient.end(), 0.0);
+            double cost = 0.0;
+            for (size_t p = begin; p < end; ++p) {
+                const size_t i = order[p];
+                const utils::Span<const size_t> indices = features.innerIndices(i);
+                const utils::Span<const double> values = features.innerValues(i);
+
+                double z = fitIntercept_ ? coefficients_[0] : 0.0;
+                for (size_t k = 0; k < indices.size(); ++k) {
+                    z += values[k] * coefficients_[indices[k] + offset];
+                }
+                double probability;
+                cost += rowLoss(z, targets[i], probability);
+
+                const double error = probability - targets[i];
+                if (fitIntercept_) {
+                    gradient[0] += error;
+                }
+                for (size_t k = 0; k < indices.size(); ++k) {
+                    gradient[indices[k] + offset] += error * values[k];
+                }
+            }
+
+            const double scale = 1.0 / static_cast<double>(end - begin);
+            for (double& g : gradient) {
+                g *= scale;
             }
+            return cost * scale;
+        });
+    stats_.iterations = run.epochs;
+    stats_.loss = run.loss;
+    stats_.converged = run.converged;
+
+    return true;
+}
+
+bool LogisticRegression::fitHogwild(const utils::SparseMatrix& features,
+                                    const std::vector<double>& targets) {
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t n = features.rows();
+    optimizer_->reset(features.cols() + offset);
+
+    // Relaxed atomics make the unsynchronized reads and writes well-defined;
+    // a concurrent update to the same coordinate may be lost, which Hogwild
+    // tolerates
+    std::vector<std::atomic<double>> weights(features.cols() + offset);
+    for (std::atomic<double>& weight : weights) {
+        weight.store(0.0, std::memory_order_relaxed);
+    }
+
+    std::mt19937_64 rng(miniBatch_.seed);
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    for (size_t epoch = 0; epoch < miniBatch_.epochs && n > 0; ++epoch) {
+        optimizer_->beginEpoch(epoch);
+        const double rate = optimizer_->learningRate();
+        if (miniBatch_.shuffle) {
+            std::shuffle(order.begin(), order.end(), rng);
         }
+
+        double epochCost = 0.0;
+        std::mutex costMutex;
+        utils::parallelFor(0, n, kHogwildGrain, [&](size_t lo, size_t hi) {
+            double cost = 0.0;
+            for (size_t p = lo; p < hi; ++p) {
+                const size_t i = order[p];
+                const utils::Span<const size_t> indices = features.innerIndices(i);
+                const utils::Span<const double> values = features.innerValues(i);
+
+                double z = fitIntercept_ ? weights[0].load(std::memory_order_relaxed) : 0.0;
+                for (size_t k = 0; k < indices.size(); ++k) {
+                    z += values[k] * weights[indices[k] + offset].load(std::memory_order_relaxed);
+                }
+                double probability;
+                cost += rowLoss(z, targets[i], probability);
+
+                const double step = rate * (probability - targets[i]);
+                if (fitIntercept_) {
+                    weights[0].store(weights[0].load(std::memory_order_relaxed) - step,
+                                     std::memory_order_relaxed);
+                }
+                for (size_t k = 0; k < indices.size(); ++k) {
+                    std::atomic<double>& weight = weights[indices[k] + offset];
+                    weight.store(weight.load(std::memory_order_relaxed) - step * values[k],
+                                 std::memory_order_relaxed);
+                }
+            }
+            std::lock_guard<std::mutex> lock(costMutex);
+            epochCost += cost;
+        });
+        stats_.iterations = epoch + 1;
+        stats_.loss = epochCost / n;
+        if (stats_.loss < tolerance_) {
+            stats_.converged = true;
+            break;
+        }
+    }
+
+    coefficients_.resize(weights.size());
+    for (size_t j = 0; j < weights.size(); ++j) {
+        coefficients_[j] = weights[j].load(std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool LogisticRegression::train(data::BatchSource& source, size_t epochs) {
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t cols = source.cols();
+    coefficients_ = std::vector<double>(cols + offset, 0.0);
+
+    data::Batch batch;
+    std::vector<double> gradient(cols + offset);
+    std::vector<double> partials;
+    size_t samples = 0;
+    if (optimizer_) {
+        optimizer_->reset(coefficients_.size());
     }
 
-    std::vector<double> predictions(X.rows());
-    for (size_t i = 0; i < X.rows(); ++i) {
-        double z = 0.0;
-        for (size_t j = 0; j < X.cols(); ++j) {
-            z += X[i][j] * coefficients_[j];
+    for (size_t epoch = 0; epoch < epochs; ++epoch) {
+        double epochCost = 0.0;
+        size_t epochRows = 0;
+        if (optimizer_) {
+            optimizer_->beginEpoch(epoch);
+        }
+
+        source.reset();
+        while (source.next(batch)) {
+            const size_t rows = batch.rows();
+            epochCost += lossAndGradient(utils::MatrixView(batch.features), batch.targets,
+                                         0, rows, gradient, partials) * rows;
+
+            if (optimizer_) {
+                optimizer_->step(coefficients_, gradient);
+            } else {
+                for (size_t j = 0; j < gradient.size(); ++j) {
+                    coefficients_[j] -= learningRate_ * gradient[j];
+                }
+            }
+            epochRows += rows;
+        }
+
+        samples += epochRows;
+        if (epochRows == 0 || epochCost / epochRows < tolerance_) {
+            break;
         }
-        predictions[i] = sigmoid(z);
     }
 
+    return samples > 0;
+}
+
+std::vector<double> LogisticRegression::predict(const utils::SparseMatrix& features) const {
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    if (coefficients_.size() != features.cols() + offset) {
+        throw std::invalid_argument("Feature count does not match the trained model");
+    }
+
+    std::vector<double> predictions = features.multiply(
+        utils::Span<const double>(coefficients_.data() + offset, features.cols()));
+    for (double& prediction : predictions) {
+        prediction = sigmoid(prediction + (fitIntercept_ ? coefficients_[0] : 0.0));
+    }
     return predictions;
 }
 
+template <typename T>
+std::vector<double> LogisticRegression::predictRows(const utils::BasicMatrixView<T>& features) const {
+    std::vector<double> predictions(features.rows());
+    predictInto(features, predictions);
+    return predictions;
+}
+
+template <typename T>
+void LogisticRegression::predictInto(const utils::BasicMatrixView<T>& features,
+                                     std::vector<double>& predictions) const {
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    if (coefficients_.size() != features.cols() + offset) {
+        throw std::invalid_argument("Feature count does not match the trained model");
+    }
+
+    for (size_t i = 0; i < features.rows(); ++i) {
+        const T* row = features.rowPtr(i);
+        double z = fitIntercept_ ? coefficients_[0] : 0.0;
+        for (size_t j = 0; j < features.cols(); ++j) {
+            z += row[j] * coefficients_[j + offset];
+        }
+        predictions[i] = sigmoid(z);
+    }
+}
+
 std::vector<double> LogisticRegression::getParameters() const {
     return coefficients_;
 }
@@ -85,15 +666,42 @@ double LogisticRegression::sigmoid(double x) {
     return 1.0 / (1.0 + std::exp(-x));
 }
 
-double LogisticRegression::computeCost(const utils::Matrix& features,
-                                       const std::vector<double>& targets) const {
-    std::vector<double> predictions = predict(features);
-    double cost = 0.0;
-    for (size_t i = 0; i < predictions.size(); ++i) {
-        cost -= targets[i] * std::log(predictions[i]) +
-                (1 - targets[i]) * std::log(1 - predictions[i]);
-    }
-    return cost / predictions.size();
+template <typename T>
+double LogisticRegression::lossAndGradient(const utils::BasicMatrixView<T>& features,
+                                           utils::Span<const double> targets,
+                                           size_t begin, size_t end,
+                                           std::vector<double>& gradient,
+                                           std::vector<double>& partials) const {
+    const size_t rows = end - begin;
+    const size_t cols = features.cols();
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t width = cols + offset;
+    const double intercept = fitIntercept_ ? coefficients_[0] : 0.0;
+    const double* weights = coefficients_.data() + offset;
+
+    return reduceBlocks(rows, gradient, partials,
+                        [&](size_t first, size_t count, double* grad) {
+        double* weightGrad = grad + offset;
+        double loss = 0.0;
+        for (size_t i = begin + first; i < begin + first + count; ++i) {
+            const T* row = features.rowPtr(i);
+            double z = intercept;
+            for (size_t j = 0; j < cols; ++j) {
+                z += row[j] * weights[j];
+            }
+            double probability;
+            loss += rowLoss(z, targets[i], probability);
+
+            const double error = probability - targets[i];
+            if (fitIntercept_) {
+                grad[0] += error;
+            }
+            for (size_t j = 0; j < cols; ++j) {
+                weightGrad[j] += error * row[j];
+            }
+        }
+        grad[width] = loss;
+    });
 }
 
 } // namespace models
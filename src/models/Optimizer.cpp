@@ -0,0 +1,141 @@
+#include "../../include/models/Optimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace ml {
+namespace models {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+} // namespace
+
+LearningRateSchedule::LearningRateSchedule(Kind kind, size_t period, double rate)
+    : kind_(kind), period_(period), rate_(rate) {}
+
+LearningRateSchedule LearningRateSchedule::constant() {
+    return LearningRateSchedule(Kind::Constant, 1, 1.0);
+}
+
+LearningRateSchedule LearningRateSchedule::stepDecay(size_t every, double gamma) {
+    if (every == 0) {
+        throw std::invalid_argument("Step decay period must be positive");
+    }
+    return LearningRateSchedule(Kind::StepDecay, every, gamma);
+}
+
+LearningRateSchedule LearningRateSchedule::exponential(double gamma) {
+    return LearningRateSchedule(Kind::Exponential, 1, gamma);
+}
+
+LearningRateSchedule LearningRateSchedule::inverseTime(double decay) {
+    return LearningRateSchedule(Kind::InverseTime, 1, decay);
+}
+
+LearningRateSchedule LearningRateSchedule::cosine(size_t totalEpochs, double minFactor) {
+    if (totalEpochs == 0) {
+        throw std::invalid_argument("Cosine schedule needs at least one epoch");
+    }
+    return LearningRateSchedule(Kind::Cosine, totalEpochs, minFactor);
+}
+
+double LearningRateSchedule::factor(size_t epoch) const {
+    switch (kind_) {
+        case Kind::StepDecay:
+            return std::pow(rate_, static_cast<double>(epoch / period_));
+        case Kind::Exponential:
+            return std::pow(rate_, static_cast<double>(epoch));
+        case Kind::InverseTime:
+            return 1.0 / (1.0 + rate_ * static_cast<double>(epoch));
+        case Kind::Cosine: {
+            const double progress = std::min(1.0, static_cast<double>(epoch) / period_);
+            return rate_ + (1.0 - rate_) * 0.5 * (1.0 + std::cos(kPi * progress));
+        }
+        case Kind::Constant:
+        default:
+            return 1.0;
+    }
+}
+
+Optimizer::Optimizer(double learningRate)
+    : baseRate_(learningRate), learningRate_(learningRate) {
+    if (learningRate <= 0.0) {
+        throw std::invalid_argument("Learning rate must be positive");
+    }
+}
+
+void Optimizer::reset(size_t /*parameters*/) {
+    steps_ = 0;
+    learningRate_ = baseRate_;
+}
+
+void Optimizer::beginEpoch(size_t epoch) {
+    learningRate_ = baseRate_ * schedule_.factor(epoch);
+}
+
+SGD::SGD(double learningRate, double momentum, bool nesterov)
+    : Optimizer(learningRate), momentum_(momentum), nesterov_(nesterov) {
+    if (momentum < 0.0 || momentum >= 1.0) {
+        throw std::invalid_argument("Momentum must be in [0, 1)");
+    }
+}
+
+void SGD::reset(size_t parameters) {
+    Optimizer::reset(parameters);
+    velocity_.assign(momentum_ > 0.0 ? parameters : 0, 0.0);
+}
+
+void SGD::step(std::vector<double>& parameters, const std::vector<double>& gradient) {
+    ++steps_;
+    if (momentum_ == 0.0) {
+        for (size_t j = 0; j < parameters.size(); ++j) {
+            parameters[j] -= learningRate_ * gradient[j];
+        }
+        return;
+    }
+
+    if (velocity_.size() != parameters.size()) {
+        velocity_.assign(parameters.size(), 0.0);
+    }
+    for (size_t j = 0; j < parameters.size(); ++j) {
+        velocity_[j] = momentum_ * velocity_[j] + gradient[j];
+        const double direction = nesterov_ ? gradient[j] + momentum_ * velocity_[j] : velocity_[j];
+        parameters[j] -= learningRate_ * direction;
+    }
+}
+
+Adam::Adam(double learningRate, double beta1, double beta2, double epsilon)
+    : Optimizer(learningRate), beta1_(beta1), beta2_(beta2), epsilon_(epsilon) {
+    if (beta1 < 0.0 || beta1 >= 1.0 || beta2 < 0.0 || beta2 >= 1.0) {
+        throw std::invalid_argument("Adam decay rates must be in [0, 1)");
+    }
+}
+
+void Adam::reset(size_t parameters) {
+    Optimizer::reset(parameters);
+    firstMoment_.assign(parameters, 0.0);
+    secondMoment_.assign(parameters, 0.0);
+}
+
+void Adam::step(std::vector<double>& parameters, const std::vector<double>& gradient) {
+    if (firstMoment_.size() != parameters.size()) {
+        firstMoment_.assign(parameters.size(), 0.0);
+        secondMoment_.assign(parameters.size(), 0.0);
+    }
+    ++steps_;
+
+    // Fold both bias corrections into the step size
+    const double t = static_cast<double>(steps_);
+    const double stepSize = learningRate_ * std::sqrt(1.0 - std::pow(beta2_, t)) /
+                            (1.0 - std::pow(beta1_, t));
+    for (size_t j = 0; j < parameters.size(); ++j) {
+        firstMoment_[j] = beta1_ * firstMoment_[j] + (1.0 - beta1_) * gradient[j];
+        secondMoment_[j] = beta2_ * secondMoment_[j] + (1.0 - beta2_) * gradient[j] * gradient[j];
+        parameters[j] -= stepSize * firstMoment_[j] / (std::sqrt(secondMoment_[j]) + epsilon_);
+    }
+}
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "../../include/models/QuantizedIndex.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ml {
+namespace models {
+
+namespace {
+
+// Rows encoded per parallel chunk
+constexpr size_t kEncodeGrain = 1024;
+
+// k-means trains each codebook on at most this many sampled rows per centroid
+constexpr size_t kSamplePerCentroid = 64;
+
+constexpr size_t kMaxCentroids = 256;
+
+float subspaceDistance(const float* a, const float* b, size_t width) {
+    float sum = 0.0f;
+    for (size_t c = 0; c < width; ++c) {
+        const float diff = a[c] - b[c];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+uint8_t nearestCentroid(const float* x, const float* codebook, size_t centroids, size_t width) {
+    size_t best = 0;
+    float bestDistance = std::numeric_limits<float>::max();
+    for (size_t j = 0; j < centroids; ++j) {
+        const float d = subspaceDistance(x, codebook + j * width, width);
+        if (d < bestDistance) {
+            bestDistance = d;
+            best = j;
+        }
+    }
+    return static_cast<uint8_t>(best);
+}
+
+} // namespace
+
+template <typename T>
+QuantizedIndex::QuantizedIndex(const utils::BasicMatrixView<T>& points,
+                               const QuantizationOptions& options)
+    : kind_(options.kind), rows_(points.rows()), dims_(points.cols()) {
+    if (options.kind == Quantization::None) {
+        throw std::invalid_argument("QuantizedIndex needs an Int8 or Product encoding");
+    }
+    if (options.kind == Quantization::Product) {
+        if (options.subspaces == 0) {
+            throw std::invalid_argument("Product quantization needs at least one subspace");
+        }
+        if (options.centroids == 0 || options.centroids > kMaxCentroids) {
+            throw std::invalid_argument("Product quantization needs 1 to 256 centroids per subspace");
+        }
+    }
+    if (rows_ == 0) {
+        return;
+    }
+
+    if (kind_ == Quantization::Int8) {
+        encodeScalar(points);
+    } else {
+        encodeProduct(points, options);
+    }
+}
+
+template <typename T>
+void QuantizedIndex::encodeScalar(const utils::BasicMatrixView<T>& points) {
+    std::vector<double> lower(dims_, std::numeric_limits<double>::infinity());
+    std::vector<double> upper(dims_, -std::numeric_limits<double>::infinity());
+    for (size_t i = 0; i < rows_; ++i) {
+        const T* row = points.rowPtr(i);
+        for (size_t c = 0; c < dims_; ++c) {
+            lower[c] = std::min(lower[c], static_cast<double>(row[c]));
+            upper[c] = std::max(upper[c], static_cast<double>(row[c]));
+        }
+    }
+
+    offsets_.resize(dims_);
+    steps_.resize(dims_);
+    for (size_t c = 0; c < dims_; ++c) {
+        const double range = upper[c] - lower[c];
+        offsets_[c] = static_cast<float>(lower[c]);
+        // A constant feature encodes as 0 whatever the step
+        steps_[c] = range > 0.0 ? static_cast<float>(range / 255.0) : 1.0f;
+    }
+
+    codeSize_ = dims_;
+    codes_.resize(rows_ * codeSize_);
+    utils::parallelFor(0, rows_, kEncodeGrain, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            const T* row = points.rowPtr(i);
+            uint8_t* code = codes_.data() + i * codeSize_;
+            for (size_t c = 0; c < dims_; ++c) {
+                const double level = std::round((row[c] - offsets_[c]) / steps_[c]);
+                code[c] = static_cast<uint8_t>(std::min(255.0, std::max(0.0, level)));
+            }
+        }
+    });
+}
+
+template <typename T>
+void QuantizedIndex::encodeProduct(const utils::BasicMatrixView<T>& points,
+                                   const QuantizationOptions& options) {
+    const size_t subspaces = std::min(options.subspaces, dims_);
+    bounds_.resize(subspaces + 1);
+    for (size_t s = 0; s <= subspaces; ++s) {
+        bounds_[s] = s * dims_ / subspaces;
+    }
+    centroids_ = std::min(options.centroids, rows_);
+    codeSize_ = subspaces;
+
+    // The sample is shuffled, so its first rows double as the initial centroids
+    std::mt19937_64 rng(options.seed);
+    std::vector<size_t> sample(rows_);
+    std::iota(sample.begin(), sample.end(), 0);
+    std::shuffle(sample.begin(), sample.end(), rng);
+    sample.resize(std::min(rows_, centroids_ * kSamplePerCentroid));
+
+    codebooks_.assign(centroids_ * dims_, 0.0f);
+    std::vector<float> data;
+    std::vector<uint8_t> assignment(sample.size());
+    std::vector<uint8_t> previous;
+    std::vector<double> sums;
+    std::vector<size_t> counts;
+    for (size_t s = 0; s < subspaces; ++s) {
+        const size_t first = bounds_[s];
+        const size_t width = bounds_[s + 1] - first;
+        float* codebook = codebooks_.data() + centroids_ * first;
+
+        data.resize(sample.size() * width);
+        for (size_t i = 0; i < sample.size(); ++i) {
+            const T* row = points.rowPtr(sample[i]) + first;
+            std::copy(row, row + width, data.data() + i * width);
+        }
+        std::copy(data.begin(), data.begin() + centroids_ * width, codebook);
+
+        // Lloyd iterations; a centroid that loses all its rows stays where it was
+        for (size_t iteration = 0; iteration < options.iterations; ++iteration) {
+            previous = assignment;
+            utils::parallelFor(0, sample.size(), kEncodeGrain, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    assignment[i] = nearestCentroid(data.data() + i * width, codebook, centroids_, width);
+                }
+            });
+            if (iteration > 0 && assignment == previous) {
+                break;
+            }
+
+            sums.assign(centroids_ * width, 0.0);
+            counts.assign(centroids_, 0);
+            for (size_t i = 0; i < sample.size(); ++i) {
+                const float* x = data.data() + i * width;
+                double* sum = sums.data() + assignment[i] * width;
+                for (size_t c = 0; c < width; ++c) {
+                    sum[c] += x[c];
+                }
+                ++counts[assignment[i]];
+            }
+            for (size_t j = 0; j < centroids_; ++j) {
+                if (counts[j] == 0) {
+                    continue;
+                }
+                for (size_t c = 0; c < width; ++c) {
+                    codebook[j * width + c] = static_cast<float>(sums[j * width + c] / counts[j]);
+                }
+            }
+        }
+    }
+
+    codes_.resize(rows_ * codeSize_);
+    utils::parallelFor(0, rows_, kEncodeGrain, [&](size_t lo, size_t hi) {
+        std::vector<float> x(dims_);
+        for (size_t i = lo; i < hi; ++i) {
+            const T* row = points.rowPtr(i);
+            std::copy(row, row + dims_, x.begin());
+            uint8_t* code = codes_.data() + i * codeSize_;
+            for (size_t s = 0; s < codeSize_; ++s) {
+                const size_t first = bounds_[s];
+                const size_t width = bounds_[s + 1] - first;
+                code[s] = nearestCentroid(x.data() + first, codebooks_.data() + centroids_ * first,
+                                          centroids_, width);
+            }
+        }
+    });
+}
+
+template <typename T>
+void QuantizedIndex::query(const T* point, size_t count, std::vector<Neighbor>& out) const {
+    out.clear();
+    if (count == 0 || empty()) {
+        return;
+    }
+
+    if (kind_ == Quantization::Int8) {
+        // Squared distance from each query value to every level of its feature
+        std::vector<float> table(dims_ * 256);
+        for (size_t c = 0; c < dims_; ++c) {
+            float* levels = table.data() + c * 256;
+            for (size_t level = 0; level < 256; ++level) {
+                const double diff = point[c] - (offsets_[c] + steps_[c] * static_cast<float>(level));
+                levels[level] = static_cast<float>(diff * diff);
+            }
+        }
+        scan(count, [&](const uint8_t* code) {
+            float sum = 0.0f;
+            for (size_t c = 0; c < dims_; ++c) {
+                sum += table[c * 256 + code[c]];
+            }
+            return sum;
+        }, out);
+        return;
+    }
+
+    // Distance from each query sub-vector to every centroid of its subspace
+    std::vector<float> x(point, point + dims_);
+    std::vector<float> table(codeSize_ * centroids_);
+    for (size_t s = 0; s < codeSize_; ++s) {
+        const size_t first = bounds_[s];
+        const size_t width = bounds_[s + 1] - first;
+        const float* codebook = codebooks_.data() + centroids_ * first;
+        for (size_t j = 0; j < centroids_; ++j) {
+            table[s * centroids_ + j] = subspaceDistance(x.data() + first, codebook + j * width, width);
+        }
+    }
+    scan(count, [&](const uint8_t* code) {
+        float sum = 0.0f;
+        for (size_t s = 0; s < codeSize_; ++s) {
+            sum += table[s * centroids_ + code[s]];
+        }
+        return sum;
+    }, out);
+}
+
+template <typename Distance>
+void QuantizedIndex::scan(size_t count, const Distance& distance, std::vector<Neighbor>& out) const {
+    NeighborHeap heap(std::min(count, rows_));
+    for (size_t i = 0; i < rows_; ++i) {
+        const double d = distance(codes_.data() + i * codeSize_);
+        if (!heap.full() || d <= heap.worst()) {
+            heap.push(d, i);
+        }
+    }
+    heap.sortedInto(out);
+}
+
+size_t QuantizedIndex::memoryBytes() const {
+    return codes_.size() * sizeof(uint8_t) +
+           (offsets_.size() + steps_.size() + codebooks_.size()) * sizeof(float) +
+           bounds_.size() * sizeof(size_t);
+}
+
+template QuantizedIndex::QuantizedIndex(const utils::BasicMatrixView<float>&, const QuantizationOptions&);
+template QuantizedIndex::QuantizedIndex(const utils::BasicMatrixView<double>&, const QuantizationOptions&);
+template void QuantizedIndex::query(const float*, size_t, std::vector<Neighbor>&) const;
+template void QuantizedIndex::query(const double*, size_t, std::vector<Neighbor>&) const;
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
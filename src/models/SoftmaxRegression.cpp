@@ -0,0 +1,267 @@
+#include "../../include/models/SoftmaxRegression.hpp"
+#include "../../include/models/GradientTraining.hpp"
+#include "../../include/utils/Gemm.hpp"
+#include "../../include/utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace ml {
+namespace models {
+
+namespace {
+
+// Rows scored per gemm at prediction time
+constexpr size_t kBlockRows = 256;
+
+// Callers use only the first `rows` rows, so a buffer shaped for a full
+// block also serves the shorter last one
+void ensureShape(utils::Matrix& matrix, size_t rows, size_t cols) {
+    if (matrix.rows() < rows || matrix.cols() != cols) {
+        matrix = utils::Matrix(rows, cols);
+    }
+}
+
+} // namespace
+
+SoftmaxRegression::SoftmaxRegression(double learningRate, size_t maxIterations,
+                                     double tolerance, bool fitIntercept)
+    : learningRate_(learningRate), maxIterations_(maxIterations),
+      tolerance_(tolerance), fitIntercept_(fitIntercept) {}
+
+bool SoftmaxRegression::train(const utils::MatrixView& features,
+                              const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+bool SoftmaxRegression::train(const utils::MatrixViewF& features,
+                              const std::vector<double>& targets) {
+    return fit(features, targets);
+}
+
+void SoftmaxRegression::setOptimizer(std::shared_ptr<Optimizer> optimizer,
+                                     MiniBatchOptions options) {
+    validateMiniBatchOptions(options);
+    optimizer_ = std::move(optimizer);
+    miniBatch_ = options;
+}
+
+std::vector<double> SoftmaxRegression::predict(const utils::MatrixView& features) const {
+    return predictRows(features);
+}
+
+std::vector<double> SoftmaxRegression::predict(const utils::MatrixViewF& features) const {
+    return predictRows(features);
+}
+
+utils::Matrix SoftmaxRegression::predictProbabilities(const utils::MatrixView& features) const {
+    return probabilities(features);
+}
+
+utils::Matrix SoftmaxRegression::predictProbabilities(const utils::MatrixViewF& features) const {
+    return probabilities(features);
+}
+
+std::vector<double> SoftmaxRegression::getParameters() const {
+    return weights_;
+}
+
+template <typename T>
+bool SoftmaxRegression::fit(const utils::BasicMatrixView<T>& features,
+                            const std::vector<double>& targets) {
+    if (features.rows() != targets.size()) {
+        throw std::invalid_argument("Number of samples in features and targets must match");
+    }
+
+    classes_ = targets;
+    std::sort(classes_.begin(), classes_.end());
+    classes_.erase(std::unique(classes_.begin(), classes_.end()), classes_.end());
+    if (classes_.size() < 2) {
+        // Leave no half-trained model behind
+        classes_.clear();
+        weights_.clear();
+        features_ = 0;
+        return false;
+    }
+
+    labels_.resize(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        labels_[i] = std::lower_bound(classes_.begin(), classes_.end(), targets[i]) - classes_.begin();
+    }
+
+    features_ = features.cols();
+    weights_.assign((features_ + (fitIntercept_ ? 1 : 0)) * classes_.size(), 0.0);
+
+    if (optimizer_) {
+        fitMiniBatch(features, labels_);
+        return true;
+    }
+
+    // Scratch lives in members, so once a fit of this shape has run, later
+    // fits (and every iteration) reuse it instead of allocating
+    gradient_.assign(weights_.size(), 0.0);
+    for (size_t iteration = 0; iteration < maxIterations_; ++iteration) {
+        lossAndGradient(features, utils::Span<const size_t>(labels_), 0, features.rows(),
+                        gradient_, partials_);
+        if (maxAbs(gradient_) <= tolerance_) {
+            break;
+        }
+        for (size_t j = 0; j < weights_.size(); ++j) {
+            weights_[j] -= learningRate_ * gradient_[j];
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+void SoftmaxRegression::fitMiniBatch(const utils::BasicMatrixView<T>& features,
+                                     const std::vector<size_t>& labels) {
+    // One gathered view per epoch; batches are then contiguous row ranges of it
+    utils::BasicMatrixView<T> rows = features;
+    utils::Span<const size_t> rowLabels(labels);
+    std::vector<size_t> shuffledLabels(labels.size());
+    std::vector<double> partials;
+
+    runMiniBatches(
+        features.rows(), miniBatch_, tolerance_, *optimizer_, weights_,
+        [&](const std::vector<size_t>& order) {
+            rows = features.selectRows(order);
+            for (size_t p = 0; p < order.size(); ++p) {
+                shuffledLabels[p] = labels[order[p]];
+            }
+            rowLabels = utils::Span<const size_t>(shuffledLabels);
+        },
+        [&](size_t begin, size_t end, std::vector<double>& gradient) {
+            return lossAndGradient(rows, rowLabels, begin, end, gradient, partials);
+        });
+}
+
+template <typename T>
+double SoftmaxRegression::lossAndGradient(const utils::BasicMatrixView<T>& features,
+                                          utils::Span<const size_t> labels,
+                                          size_t begin, size_t end,
+                                          std::vector<double>& gradient,
+                                          std::vector<double>& partials) const {
+    const size_t classes = classes_.size();
+    const size_t offset = fitIntercept_ ? 1 : 0;
+    const size_t size = weights_.size();
+
+    // Each block writes its own slot: a gradient-sized matrix and one loss
+    return reduceBlocks(end - begin, gradient, partials,
+                        [&](size_t first, size_t count, double* grad) {
+        // Per-thread scratch, kept between calls so a block never allocates
+        thread_local utils::Matrix block;
+        thread_local utils::Matrix probabilities;
+        scoreBlock(features, begin + first, count, block, probabilities);
+
+        // Cross-entropy of the true class, then P - Y in place
+        double loss = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            double* p = probabilities.rowPtr(i);
+            const size_t label = labels[begin + first + i];
+            loss -= std::log(std::max(p[label], std::numeric_limits<double>::min()));
+            p[label] -= 1.0;
+            if (fitIntercept_) {
+                for (size_t c = 0; c < classes; ++c) {
+                    grad[c] += p[c];
+                }
+            }
+        }
+        grad[size] = loss;
+
+        // Feature gradient: block^T * (P - Y)
+        utils::gemm(features_, classes, count, 1.0, block.data(), block.stride(),
+                    utils::Transpose::Yes, probabilities.data(), probabilities.stride(),
+                    utils::Transpose::No, 1.0, grad + offset * classes, classes);
+    });
+}
+
+template <typename T>
+void SoftmaxRegression::scoreBlock(const utils::BasicMatrixView<T>& features, size_t begin,
+                                   size_t count, utils::Matrix& block,
+                                   utils::Matrix& probabilities) const {
+    const size_t classes = classes_.size();
+    const size_t offset = fitIntercept_ ? 1 : 0;
+
+    // Pack the rows into a contiguous double block for gemm
+    ensureShape(block, count, features_);
+    for (size_t i = 0; i < count; ++i) {
+        const T* row = features.rowPtr(begin + i);
+        std::copy(row, row + features_, block.rowPtr(i));
+    }
+
+    // Logits start from the intercepts and accumulate block * W
+    ensureShape(probabilities, count, classes);
+    for (size_t i = 0; i < count; ++i) {
+        double* z = probabilities.rowPtr(i);
+        for (size_t c = 0; c < classes; ++c) {
+            z[c] = fitIntercept_ ? weights_[c] : 0.0;
+        }
+    }
+    utils::gemm(count, classes, features_, 1.0, block.data(), block.stride(), utils::Transpose::No,
+                weights_.data() + offset * classes, classes, utils::Transpose::No,
+                1.0, probabilities.data(), probabilities.stride());
+
+    // Shift by the row maximum so exp never overflows
+    for (size_t i = 0; i < count; ++i) {
+        double* z = probabilities.rowPtr(i);
+        const double shift = *std::max_element(z, z + classes);
+        double sum = 0.0;
+        for (size_t c = 0; c < classes; ++c) {
+            z[c] = std::exp(z[c] - shift);
+            sum += z[c];
+        }
+        const double inverse = 1.0 / sum;
+        for (size_t c = 0; c < classes; ++c) {
+            z[c] *= inverse;
+        }
+    }
+}
+
+template <typename T>
+utils::Matrix SoftmaxRegression::probabilities(const utils::BasicMatrixView<T>& features) const {
+    if (classes_.empty()) {
+        throw std::runtime_error("Model must be trained before prediction");
+    }
+    if (features.cols() != features_) {
+        throw std::invalid_argument("Feature count does not match the trained model");
+    }
+
+    const size_t rows = features.rows();
+    const size_t classes = classes_.size();
+    utils::Matrix result(rows, classes);
+    const size_t blocks = (rows + kBlockRows - 1) / kBlockRows;
+
+    utils::parallelFor(0, blocks, 1, [&](size_t lo, size_t hi) {
+        utils::ThreadLimit serial(1);
+        utils::Matrix block;
+        utils::Matrix blockProbabilities;
+        for (size_t b = lo; b < hi; ++b) {
+            const size_t first = b * kBlockRows;
+            const size_t count = std::min(rows, first + kBlockRows) - first;
+            scoreBlock(features, first, count, block, blockProbabilities);
+            for (size_t i = 0; i < count; ++i) {
+                std::copy(blockProbabilities.rowPtr(i), blockProbabilities.rowPtr(i) + classes,
+                          result.rowPtr(first + i));
+            }
+        }
+    });
+
+    return result;
+}
+
+template <typename T>
+std::vector<double> SoftmaxRegression::predictRows(const utils::BasicMatrixView<T>& features) const {
+    const utils::Matrix probs = probabilities(features);
+    std::vector<double> predictions(probs.rows());
+    for (size_t i = 0; i < probs.rows(); ++i) {
+        const double* p = probs.rowPtr(i);
+        predictions[i] = classes_[std::max_element(p, p + classes_.size()) - p];
+    }
+    return predictions;
+}
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "../../include/models/SpatialIndex.hpp"
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace ml {
+namespace models {
+
+template <typename T>
+SpatialIndex<T>::SpatialIndex(const utils::BasicMatrixView<T>& points, SpatialIndexKind kind,
+                              size_t leafSize)
+    : kind_(kind), dims_(points.cols()), leafSize_(std::max<size_t>(1, leafSize)) {
+    const size_t n = points.rows();
+    order_.resize(n);
+    std::iota(order_.begin(), order_.end(), 0);
+    if (n == 0) {
+        return;
+    }
+
+    build(points, 0, n);
+
+    // Copy the rows in leaf order so each bucket is contiguous
+    points_ = utils::BasicMatrix<T>(n, dims_);
+    for (size_t i = 0; i < n; ++i) {
+        const T* row = points.rowPtr(order_[i]);
+        std::copy(row, row + dims_, points_.rowPtr(i));
+    }
+}
+
+template <typename T>
+size_t SpatialIndex<T>::build(const utils::BasicMatrixView<T>& points, size_t begin, size_t end) {
+    const size_t node = nodes_.size();
+    nodes_.push_back({begin, end, 0, 0.0});
+    geometry_.resize(geometry_.size() + stride());
+
+    std::vector<double> lower(dims_, std::numeric_limits<double>::infinity());
+    std::vector<double> upper(dims_, -std::numeric_limits<double>::infinity());
+    for (size_t i = begin; i < end; ++i) {
+        const T* row = points.rowPtr(order_[i]);
+        for (size_t c = 0; c < dims_; ++c) {
+            lower[c] = std::min(lower[c], static_cast<double>(row[c]));
+            upper[c] = std::max(upper[c], static_cast<double>(row[c]));
+        }
+    }
+
+    double* geometry = geometry_.data() + node * stride();
+    if (kind_ == SpatialIndexKind::KDTree) {
+        std::copy(lower.begin(), lower.end(), geometry);
+        std::copy(upper.begin(), upper.end(), geometry + dims_);
+    } else {
+        for (size_t i = begin; i < end; ++i) {
+            const T* row = points.rowPtr(order_[i]);
+            for (size_t c = 0; c < dims_; ++c) {
+                geometry[c] += row[c];
+            }
+        }
+        const double scale = 1.0 / static_cast<double>(end - begin);
+        for (size_t c = 0; c < dims_; ++c) {
+            geometry[c] *= scale;
+        }
+        double radius = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const T* row = points.rowPtr(order_[i]);
+            double sum = 0.0;
+            for (size_t c = 0; c < dims_; ++c) {
+                const double diff = row[c] - geometry[c];
+                sum += diff * diff;
+            }
+            radius = std::max(radius, sum);
+        }
+        nodes_[node].radius = std::sqrt(radius);
+    }
+
+    if (end - begin <= leafSize_) {
+        return node;
+    }
+    size_t dim = 0;
+    for (size_t c = 1; c < dims_; ++c) {
+        if (upper[c] - lower[c] > upper[dim] - lower[dim]) {
+            dim = c;
+        }
+    }
+    if (dims_ == 0 || !(upper[dim] > lower[dim])) {
+        // Every row is identical; splitting cannot separate them
+        return node;
+    }
+
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end,
+                     [&](size_t a, size_t b) { return points(a, dim) < points(b, dim); });
+    build(points, begin, mid);
+    const size_t right = build(points, mid, end);
+    nodes_[node].right = right;
+    return node;
+}
+
+template <typename T>
+void SpatialIndex<T>::query(const T* point, size_t k, std::vector<Neighbor>& out) const {
+    out.clear();
+    if (k == 0 || nodes_.empty()) {
+        return;
+    }
+    NeighborHeap heap(std::min(k, size()));
+    search(0, point, 0.0, heap);
+    heap.sortedInto(out);
+}
+
+template <typename T>
+double SpatialIndex<T>::lowerBound(size_t node, const T* point) const {
+    const double* geometry = geometry_.data() + node * stride();
+    if (kind_ == SpatialIndexKind::KDTree) {
+        double sum = 0.0;
+        for (size_t c = 0; c < dims_; ++c) {
+            const double x = point[c];
+            const double gap = std::max({geometry[c] - x, x - geometry[dims_ + c], 0.0});
+            sum += gap * gap;
+        }
+        return sum;
+    }
+
+    double sum = 0.0;
+    for (size_t c = 0; c < dims_; ++c) {
+        const double diff = point[c] - geometry[c];
+        sum += diff * diff;
+    }
+    const double gap = std::sqrt(sum) - nodes_[node].radius;
+    return gap > 0.0 ? gap * gap : 0.0;
+}
+
+template <typename T>
+void SpatialIndex<T>::search(size_t node, const T* point, double bound, NeighborHeap& heap) const {
+    // Strictly greater, so a row tying the k-th best can still displace it by index
+    if (heap.full() && bound > heap.worst()) {
+        return;
+    }
+
+    const Node& current = nodes_[node];
+    if (current.right == 0) {
+        for (size_t i = current.begin; i < current.end; ++i) {
+            heap.push(squaredDistance(point, points_.rowPtr(i), dims_), order_[i]);
+        }
+        return;
+    }
+
+    const size_t left = node + 1;
+    const double leftBound = lowerBound(left, point);
+    const double rightBound = lowerBound(current.right, point);
+    if (leftBound <= rightBound) {
+        search(left, point, leftBound, heap);
+        search(current.right, point, rightBound, heap);
+    } else {
+        search(current.right, point, rightBound, heap);
+        search(left, point, leftBound, heap);
+    }
+}
+
+template <typename T>
+size_t SpatialIndex<T>::memoryBytes() const {
+    return points_.rows() * points_.stride() * sizeof(T) + order_.size() * sizeof(size_t) +
+           nodes_.size() * sizeof(Node) + geometry_.size() * sizeof(double);
+}
+
+template class SpatialIndex<float>;
+template class SpatialIndex<double>;
+
+} // namespace models
+} // namespace ml
\ No newline at end of file
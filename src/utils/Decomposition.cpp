@@ -0,0 +1,604 @@
+#include "utils/Decomposition.hpp"
+#include "utils/Gemm.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace ml {
+namespace utils {
+
+namespace {
+
+// Columns per panel in the blocked factorizations; the trailing update of
+// each panel is a gemm of this depth.
+constexpr size_t kBlockSize = 64;
+
+Matrix columnToMatrix(const std::vector<double>& values) {
+    Matrix result(values.size(), 1);
+    std::copy(values.begin(), values.end(), result.data());
+    return result;
+}
+
+std::vector<double> matrixToColumn(const Matrix& matrix) {
+    return std::vector<double>(matrix.data(), matrix.data() + matrix.rows());
+}
+
+// rowI -= factor * rowJ over `count` entries
+inline void subtractScaledRow(double* rowI, const double* rowJ, double factor, size_t count) {
+    for (size_t c = 0; c < count; ++c) {
+        rowI[c] -= factor * rowJ[c];
+    }
+}
+
+} // namespace
+
+LUDecomposition::LUDecomposition(const Matrix& matrix)
+    : lu_(matrix), permutation_(matrix.rows()), pivotSign_(1), singular_(false) {
+    if (matrix.rows() != matrix.cols()) {
+        throw std::invalid_argument("Matrix must be square for LU decomposition");
+    }
+
+    const size_t n = lu_.rows();
+    const size_t ld = lu_.stride();
+    std::iota(permutation_.begin(), permutation_.end(), 0);
+
+    for (size_t k0 = 0; k0 < n; k0 += kBlockSize) {
+        const size_t kEnd = std::min(n, k0 + kBlockSize);
+
+        // Factor the panel (columns k0..kEnd) with partial pivoting. Row
+        // swaps move whole rows so the permutation applies everywhere.
+        for (size_t j = k0; j < kEnd; ++j) {
+            size_t pivotRow = j;
+            double maxAbs = std::abs(lu_(j, j));
+            for (size_t i = j + 1; i < n; ++i) {
+                double value = std::abs(lu_(i, j));
+                if (value > maxAbs) {
+                    maxAbs = value;
+                    pivotRow = i;
+                }
+            }
+
+            if (maxAbs == 0.0) {
+                singular_ = true;
+                continue;
+            }
+
+            if (pivotRow != j) {
+                std::swap_ranges(lu_.rowPtr(j), lu_.rowPtr(j) + n, lu_.rowPtr(pivotRow));
+                std::swap(permutation_[j], permutation_[pivotRow]);
+                pivotSign_ = -pivotSign_;
+            }
+
+            const double* pivotRowPtr = lu_.rowPtr(j);
+            const double pivot = pivotRowPtr[j];
+            for (size_t i = j + 1; i < n; ++i) {
+                double* row = lu_.rowPtr(i);
+                row[j] /= pivot;
+                if (row[j] != 0.0) {
+                    subtractScaledRow(row + j + 1, pivotRowPtr + j + 1, row[j], kEnd - j - 1);
+                }
+            }
+        }
+
+        if (kEnd == n) {
+            break;
+        }
+
+        // U12 = L11^-1 * A12
+        for (size_t j = k0; j < kEnd; ++j) {
+            const double* source = lu_.rowPtr(j) + kEnd;
+            for (size_t i = j + 1; i < kEnd; ++i) {
+                subtractScaledRow(lu_.rowPtr(i) + kEnd, source, lu_(i, j), n - kEnd);
+            }
+        }
+
+        // A22 -= L21 * U12
+        gemm(n - kEnd, n - kEnd, kEnd - k0, -1.0,
+             lu_.rowPtr(kEnd) + k0, ld, Transpose::No,
+             lu_.rowPtr(k0) + kEnd, ld, Transpose::No,
+             1.0, lu_.rowPtr(kEnd) + kEnd, ld);
+    }
+}
+
+Matrix LUDecomposition::solve(const Matrix& rhs) const {
+    const size_t n = lu_.rows();
+    if (rhs.rows() != n) {
+        throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+    }
+    if (singular_) {
+        throw std::runtime_error("Matrix is singular");
+    }
+
+    const size_t r = rhs.cols();
+    Matrix x(n, r);
+    for (size_t i = 0; i < n; ++i) {
+        std::copy(rhs.rowPtr(permutation_[i]), rhs.rowPtr(permutation_[i]) + r, x.rowPtr(i));
+    }
+
+    // Forward substitution with unit lower L
+    for (size_t i = 0; i < n; ++i) {
+        double* xi = x.rowPtr(i);
+        const double* li = lu_.rowPtr(i);
+        for (size_t j = 0; j < i; ++j) {
+            if (li[j] != 0.0) {
+                subtractScaledRow(xi, x.rowPtr(j), li[j], r);
+            }
+        }
+    }
+
+    // Back substitution with U
+    for (size_t i = n; i-- > 0;) {
+        double* xi = x.rowPtr(i);
+        const double* ui = lu_.rowPtr(i);
+        for (size_t j = i + 1; j < n; ++j) {
+            if (ui[j] != 0.0) {
+                subtractScaledRow(xi, x.rowPtr(j), ui[j], r);
+            }
+        }
+        const double inv = 1.0 / ui[i];
+        for (size_t c = 0; c < r; ++c) {
+            xi[c] *= inv;
+        }
+    }
+
+    return x;
+}
+
+std::vector<double> LUDecomposition::solve(const std::vector<double>& rhs) const {
+    return matrixToColumn(solve(columnToMatrix(rhs)));
+}
+
+Matrix LUDecomposition::inverse() const {
+    return solve(Matrix::identity(lu_.rows()));
+}
+
+double LUDecomposition::determinant() const {
+    if (singular_) {
+        return 0.0;
+    }
+    double det = pivotSign_;
+    for (size_t i = 0; i < lu_.rows(); ++i) {
+        det *= lu_(i, i);
+    }
+    return det;
+}
+
+double LUDecomposition::logDeterminant() const {
+    if (singular_) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    double logDet = 0.0;
+    for (size_t i = 0; i < lu_.rows(); ++i) {
+        logDet += std::log(std::abs(lu_(i, i)));
+    }
+    return logDet;
+}
+
+int LUDecomposition::determinantSign() const {
+    if (singular_) {
+        return 0;
+    }
+    int sign = pivotSign_;
+    for (size_t i = 0; i < lu_.rows(); ++i) {
+        if (lu_(i, i) < 0.0) {
+            sign = -sign;
+        }
+    }
+    return sign;
+}
+
+Matrix LUDecomposition::L() const {
+    const size_t n = lu_.rows();
+    Matrix result = Matrix::identity(n);
+    for (size_t i = 0; i < n; ++i) {
+        std::copy(lu_.rowPtr(i), lu_.rowPtr(i) + i, result.rowPtr(i));
+    }
+    return result;
+}
+
+Matrix LUDecomposition::U() const {
+    const size_t n = lu_.rows();
+    Matrix result(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        std::copy(lu_.rowPtr(i) + i, lu_.rowPtr(i) + n, result.rowPtr(i) + i);
+    }
+    return result;
+}
+
+CholeskyDecomposition::CholeskyDecomposition(const Matrix& matrix)
+    : l_(matrix), positiveDefinite_(true) {
+    if (matrix.rows() != matrix.cols()) {
+        throw std::invalid_argument("Matrix must be square for Cholesky decomposition");
+    }
+
+    const size_t n = l_.rows();
+    const size_t ld = l_.stride();
+
+    for (size_t k0 = 0; k0 < n && positiveDefinite_; k0 += kBlockSize) {
+        const size_t kEnd = std::min(n, k0 + kBlockSize);
+
+        // Factor the diagonal block L11
+        for (size_t j = k0; j < kEnd; ++j) {
+            double* rj = l_.rowPtr(j);
+            double d = rj[j];
+            for (size_t p = k0; p < j; ++p) {
+                d -= rj[p] * rj[p];
+            }
+            if (!(d > 0.0)) {
+                positiveDefinite_ = false;
+                break;
+            }
+            rj[j] = std::sqrt(d);
+            for (size_t i = j + 1; i < kEnd; ++i) {
+                double* ri = l_.rowPtr(i);
+                double s = ri[j];
+                for (size_t p = k0; p < j; ++p) {
+                    s -= ri[p] * rj[p];
+                }
+                ri[j] = s / rj[j];
+            }
+        }
+
+        if (!positiveDefinite_ || kEnd == n) {
+            break;
+        }
+
+        // L21 = A21 * L11^-T, one independent row at a time
+        detail::forRows(n - kEnd, kEnd - k0, [&](size_t lo, size_t hi) {
+            for (size_t i = kEnd + lo; i < kEnd + hi; ++i) {
+                double* ri = l_.rowPtr(i);
+                for (size_t j = k0; j < kEnd; ++j) {
+                    const double* rj = l_.rowPtr(j);
+                    double s = ri[j];
+                    for (size_t p = k0; p < j; ++p) {
+                        s -= ri[p] * rj[p];
+                    }
+                    ri[j] = s / rj[j];
+                }
+            }
+        });
+
+        // A22 -= L21 * L21^T, lower block triangle only
+        for (size_t i0 = kEnd; i0 < n; i0 += kBlockSize) {
+            const size_t iEnd = std::min(n, i0 + kBlockSize);
+            gemm(iEnd - i0, iEnd - kEnd, kEnd - k0, -1.0,
+                 l_.rowPtr(i0) + k0, ld, Transpose::No,
+                 l_.rowPtr(kEnd) + k0, ld, Transpose::Yes,
+                 1.0, l_.rowPtr(i0) + kEnd, ld);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        std::fill(l_.rowPtr(i) + i + 1, l_.rowPtr(i) + n, 0.0);
+    }
+}
+
+Matrix CholeskyDecomposition::solve(const Matrix& rhs) const {
+    const size_t n = l_.rows();
+    if (rhs.rows() != n) {
+        throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+    }
+    if (!positiveDefinite_) {
+        throw std::runtime_error("Matrix is not positive definite");
+    }
+
+    const size_t r = rhs.cols();
+    Matrix x = rhs;
+
+    // L * y = b
+    for (size_t i = 0; i < n; ++i) {
+        double* xi = x.rowPtr(i);
+        const double* li = l_.rowPtr(i);
+        for (size_t j = 0; j < i; ++j) {
+            subtractScaledRow(xi, x.rowPtr(j), li[j], r);
+        }
+        const double inv = 1.0 / li[i];
+        for (size_t c = 0; c < r; ++c) {
+            xi[c] *= inv;
+        }
+    }
+
+    // L^T * x = y, walking rows of L so access stays contiguous
+    for (size_t i = n; i-- > 0;) {
+        double* xi = x.rowPtr(i);
+        const double* li = l_.rowPtr(i);
+        const double inv = 1.0 / li[i];
+        for (size_t c = 0; c < r; ++c) {
+            xi[c] *= inv;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            subtractScaledRow(x.rowPtr(j), xi, li[j], r);
+        }
+    }
+
+    return x;
+}
+
+std::vector<double> CholeskyDecomposition::solve(const std::vector<double>& rhs) const {
+    return matrixToColumn(solve(columnToMatrix(rhs)));
+}
+
+Matrix CholeskyDecomposition::inverse() const {
+    return solve(Matrix::identity(l_.rows()));
+}
+
+double CholeskyDecomposition::determinant() const {
+    if (!positiveDefinite_) {
+        throw std::runtime_error("Matrix is not positive definite");
+    }
+    double det = 1.0;
+    for (size_t i = 0; i < l_.rows(); ++i) {
+        det *= l_(i, i) * l_(i, i);
+    }
+    return det;
+}
+
+double CholeskyDecomposition::logDeterminant() const {
+    if (!positiveDefinite_) {
+        throw std::runtime_error("Matrix is not positive definite");
+    }
+    double logDet = 0.0;
+    for (size_t i = 0; i < l_.rows(); ++i) {
+        logDet += 2.0 * std::log(l_(i, i));
+    }
+    return logDet;
+}
+
+Matrix CholeskyDecomposition::L() const {
+    return l_;
+}
+
+QRDecomposition::QRDecomposition(const Matrix& matrix)
+    : qr_(matrix), tau_(matrix.cols(), 0.0) {
+    if (matrix.rows() < matrix.cols()) {
+        throw std::invalid_argument("QR decomposition requires at least as many rows as columns");
+    }
+
+    const size_t m = qr_.rows();
+    const size_t n = qr_.cols();
+    const size_t ld = qr_.stride();
+
+    for (size_t k0 = 0; k0 < n; k0 += kBlockSize) {
+        const size_t kEnd = std::min(n, k0 + kBlockSize);
+        const size_t kb = kEnd - k0;
+
+        // Factor the panel one reflector at a time: H_j = I - tau_j v_j v_j^T
+        // with v_j(j) = 1 and the rest of v_j stored below the diagonal.
+        for (size_t j = k0; j < kEnd; ++j) {
+            const double x0 = qr_(j, j);
+            double sigma = 0.0;
+            for (size_t i = j + 1; i < m; ++i) {
+                sigma += qr_(i, j) * qr_(i, j);
+            }
+            if (sigma == 0.0) {
+                tau_[j] = 0.0;
+                continue;
+            }
+
+            const double norm = std::sqrt(x0 * x0 + sigma);
+            const double beta = x0 <= 0.0 ? norm : -norm;
+            const double scale = 1.0 / (x0 - beta);
+            for (size_t i = j + 1; i < m; ++i) {
+                qr_(i, j) *= scale;
+            }
+            qr_(j, j) = beta;
+            tau_[j] = (beta - x0) / beta;
+
+            // Apply H_j to the remaining panel columns, streaming rows
+            const size_t width = kEnd - j - 1;
+            if (width == 0) {
+                continue;
+            }
+            std::vector<double> w(qr_.rowPtr(j) + j + 1, qr_.rowPtr(j) + kEnd);
+            for (size_t i = j + 1; i < m; ++i) {
+                const double vi = qr_(i, j);
+                const double* row = qr_.rowPtr(i) + j + 1;
+                for (size_t c = 0; c < width; ++c) {
+                    w[c] += vi * row[c];
+                }
+            }
+            subtractScaledRow(qr_.rowPtr(j) + j + 1, w.data(), tau_[j], width);
+            for (size_t i = j + 1; i < m; ++i) {
+                subtractScaledRow(qr_.rowPtr(i) + j + 1, w.data(), tau_[j] * qr_(i, j), width);
+            }
+        }
+
+        if (kEnd == n) {
+            break;
+        }
+
+        // Compact WY form of the panel: H_k0 ... H_kEnd-1 = I - V T V^T
+        const size_t rows = m - k0;
+        Matrix V(rows, kb);
+        for (size_t r = 0; r < rows; ++r) {
+            for (size_t c = 0; c < kb && c <= r; ++c) {
+                V(r, c) = (r == c) ? 1.0 : qr_(k0 + r, k0 + c);
+            }
+        }
+
+        Matrix T(kb, kb);
+        for (size_t c = 0; c < kb; ++c) {
+            const double tau = tau_[k0 + c];
+            T(c, c) = tau;
+            if (c == 0 || tau == 0.0) {
+                continue;
+            }
+            // z = V(:, 0:c)^T v_c, then T(0:c, c) = -tau * T(0:c, 0:c) z
+            std::vector<double> z(c, 0.0);
+            for (size_t r = c; r < rows; ++r) {
+                const double vr = V(r, c);
+                const double* vrow = V.rowPtr(r);
+                for (size_t p = 0; p < c; ++p) {
+                    z[p] += vrow[p] * vr;
+                }
+            }
+            for (size_t p = 0; p < c; ++p) {
+                double s = 0.0;
+                for (size_t q = p; q < c; ++q) {
+                    s += T(p, q) * z[q];
+                }
+                T(p, c) = -tau * s;
+            }
+        }
+
+        // Trailing columns: A2 = (I - V T^T V^T) A2
+        const size_t trailing = n - kEnd;
+        Matrix W(kb, trailing);
+        gemm(kb, trailing, rows, 1.0, V.data(), V.stride(), Transpose::Yes,
+             qr_.rowPtr(k0) + kEnd, ld, Transpose::No, 0.0, W.data(), W.stride());
+        Matrix TW(kb, trailing);
+        gemm(kb, trailing, kb, 1.0, T.data(), T.stride(), Transpose::Yes,
+             W.data(), W.stride(), Transpose::No, 0.0, TW.data(), TW.stride());
+        gemm(rows, trailing, kb, -1.0, V.data(), V.stride(), Transpose::No,
+             TW.data(), TW.stride(), Transpose::No, 1.0, qr_.rowPtr(k0) + kEnd, ld);
+    }
+}
+
+bool QRDecomposition::isFullRank() const {
+    const size_t n = qr_.cols();
+    double maxDiag = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        maxDiag = std::max(maxDiag, std::abs(qr_(i, i)));
+    }
+    const double tolerance = std::max(qr_.rows(), n) *
+                             std::numeric_limits<double>::epsilon() * maxDiag;
+    for (size_t i = 0; i < n; ++i) {
+        if (!(std::abs(qr_(i, i)) > tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void QRDecomposition::applyQTranspose(Matrix& rhs) const {
+    const size_t m = qr_.rows();
+    const size_t r = rhs.cols();
+    std::vector<double> w(r);
+    for (size_t j = 0; j < qr_.cols(); ++j) {
+        if (tau_[j] == 0.0) {
+            continue;
+        }
+        std::copy(rhs.rowPtr(j), rhs.rowPtr(j) + r, w.begin());
+        for (size_t i = j + 1; i < m; ++i) {
+            const double vi = qr_(i, j);
+            const double* row = rhs.rowPtr(i);
+            for (size_t c = 0; c < r; ++c) {
+                w[c] += vi * row[c];
+            }
+        }
+        subtractScaledRow(rhs.rowPtr(j), w.data(), tau_[j], r);
+        for (size_t i = j + 1; i < m; ++i) {
+            subtractScaledRow(rhs.rowPtr(i), w.data(), tau_[j] * qr_(i, j), r);
+        }
+    }
+}
+
+void QRDecomposition::solveR(Matrix& rhs) const {
+    const size_t n = qr_.cols();
+    const size_t r = rhs.cols();
+    for (size_t i = n; i-- > 0;) {
+        double* xi = rhs.rowPtr(i);
+        const double* ri = qr_.rowPtr(i);
+        for (size_t j = i + 1; j < n; ++j) {
+            subtractScaledRow(xi, rhs.rowPtr(j), ri[j], r);
+        }
+        const double inv = 1.0 / ri[i];
+        for (size_t c = 0; c < r; ++c) {
+            xi[c] *= inv;
+        }
+    }
+}
+
+Matrix QRDecomposition::solve(const Matrix& rhs) const {
+    if (rhs.rows() != qr_.rows()) {
+        throw std::invalid_argument("Right-hand side must have as many rows as the matrix");
+    }
+    if (!isFullRank()) {
+        throw std::runtime_error("Matrix is rank deficient");
+    }
+
+    Matrix work = rhs;
+    applyQTranspose(work);
+    solveR(work);
+
+    const size_t n = qr_.cols();
+    Matrix x(n, rhs.cols());
+    for (size_t i = 0; i < n; ++i) {
+        std::copy(work.rowPtr(i), work.rowPtr(i) + rhs.cols(), x.rowPtr(i));
+    }
+    return x;
+}
+
+std::vector<double> QRDecomposition::solve(const std::vector<double>& rhs) const {
+    return matrixToColumn(solve(columnToMatrix(rhs)));
+}
+
+double QRDecomposition::determinant() const {
+    if (qr_.rows() != qr_.cols()) {
+        throw std::invalid_argument("Matrix must be square for determinant");
+    }
+    // Each non-trivial Householder reflector has determinant -1
+    double det = 1.0;
+    for (size_t i = 0; i < qr_.cols(); ++i) {
+        det *= qr_(i, i);
+        if (tau_[i] != 0.0) {
+            det = -det;
+        }
+    }
+    return det;
+}
+
+double QRDecomposition::logDeterminant() const {
+    if (qr_.rows() != qr_.cols()) {
+        throw std::invalid_argument("Matrix must be square for determinant");
+    }
+    double logDet = 0.0;
+    for (size_t i = 0; i < qr_.cols(); ++i) {
+        logDet += std::log(std::abs(qr_(i, i)));
+    }
+    return logDet;
+}
+
+Matrix QRDecomposition::R() const {
+    const size_t n = qr_.cols();
+    Matrix result(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        std::copy(qr_.rowPtr(i) + i, qr_.rowPtr(i) + n, result.rowPtr(i) + i);
+    }
+    return result;
+}
+
+Matrix QRDecomposition::Q() const {
+    const size_t m = qr_.rows();
+    const size_t n = qr_.cols();
+    Matrix q(m, n);
+    for (size_t i = 0; i < n; ++i) {
+        q(i, i) = 1.0;
+    }
+
+    // Q = H_0 H_1 ... H_n-1 applied to the first n columns of I
+    std::vector<double> w(n);
+    for (size_t j = n; j-- > 0;) {
+        if (tau_[j] == 0.0) {
+            continue;
+        }
+        std::copy(q.rowPtr(j), q.rowPtr(j) + n, w.begin());
+        for (size_t i = j + 1; i < m; ++i) {
+            const double vi = qr_(i, j);
+            const double* row = q.rowPtr(i);
+            for (size_t c = 0; c < n; ++c) {
+                w[c] += vi * row[c];
+            }
+        }
+        subtractScaledRow(q.rowPtr(j), w.data(), tau_[j], n);
+        for (size_t i = j + 1; i < m; ++i) {
+            subtractScaledRow(q.rowPtr(i), w.data(), tau_[j] * qr_(i, j), n);
+        }
+    }
+    return q;
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
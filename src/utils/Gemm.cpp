@@ -0,0 +1,563 @@
+#include "utils/Gemm.hpp"
+#include "utils/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ML_GEMM_X86 1
+#include <immintrin.h>
+#endif
+
+namespace ml {
+namespace utils {
+
+namespace {
+
+template <typename T>
+using Buffer = std::vector<T, AlignedAllocator<T>>;
+
+// Computes an mr x nr tile of alpha * A * B and adds it into c. `a` holds
+// kc packed columns of mr values, `b` holds kc packed rows of nr values.
+template <typename T>
+using MicroKernel = void (*)(size_t kc, const T* a, const T* b,
+                             T* c, size_t ldc, T alpha);
+
+template <typename T>
+struct KernelInfo {
+    const char* name;
+    MicroKernel<T> kernel;
+    size_t mr;  // rows per register tile
+    size_t nr;  // columns per register tile
+    size_t mc;  // rows of A per packed block (L2 resident)
+    size_t kc;  // depth per packed block (L1 resident B micro-panel)
+    size_t nc;  // columns of B per packed block (L3 resident)
+};
+
+// Largest mr * nr over all kernels, for the partial-tile scratch buffer
+constexpr size_t kMaxTile = 8 * 32;
+
+template <typename T>
+void kernelScalar(size_t kc, const T* a, const T* b,
+                  T* c, size_t ldc, T alpha) {
+    constexpr size_t MR = 4;
+    constexpr size_t NR = 4;
+    T acc[MR][NR] = {};
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t i = 0; i < MR; ++i) {
+            for (size_t j = 0; j < NR; ++j) {
+                acc[i][j] += a[i] * b[j];
+            }
+        }
+        a += MR;
+        b += NR;
+    }
+    for (size_t i = 0; i < MR; ++i) {
+        for (size_t j = 0; j < NR; ++j) {
+            c[i * ldc + j] += alpha * acc[i][j];
+        }
+    }
+}
+
+#ifdef ML_GEMM_X86
+__attribute__((target("avx2,fma")))
+void kernelAvx2(size_t kc, const double* a, const double* b,
+                double* c, size_t ldc, double alpha) {
+    constexpr size_t MR = 6;
+    __m256d acc[MR][2];
+#pragma GCC unroll 6
+    for (size_t i = 0; i < MR; ++i) {
+        acc[i][0] = _mm256_setzero_pd();
+        acc[i][1] = _mm256_setzero_pd();
+    }
+    for (size_t p = 0; p < kc; ++p) {
+        __m256d b0 = _mm256_loadu_pd(b);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+#pragma GCC unroll 6
+        for (size_t i = 0; i < MR; ++i) {
+            __m256d ai = _mm256_broadcast_sd(a + i);
+            acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 8;
+    }
+    __m256d scale = _mm256_set1_pd(alpha);
+#pragma GCC unroll 6
+    for (size_t i = 0; i < MR; ++i) {
+        double* row = c + i * ldc;
+        _mm256_storeu_pd(row, _mm256_fmadd_pd(scale, acc[i][0], _mm256_loadu_pd(row)));
+        _mm256_storeu_pd(row + 4, _mm256_fmadd_pd(scale, acc[i][1], _mm256_loadu_pd(row + 4)));
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void kernelAvx2(size_t kc, const float* a, const float* b,
+                float* c, size_t ldc, float alpha) {
+    constexpr size_t MR = 6;
+    __m256 acc[MR][2];
+#pragma GCC unroll 6
+    for (size_t i = 0; i < MR; ++i) {
+        acc[i][0] = _mm256_setzero_ps();
+        acc[i][1] = _mm256_setzero_ps();
+    }
+    for (size_t p = 0; p < kc; ++p) {
+        __m256 b0 = _mm256_loadu_ps(b);
+        __m256 b1 = _mm256_loadu_ps(b + 8);
+#pragma GCC unroll 6
+        for (size_t i = 0; i < MR; ++i) {
+            __m256 ai = _mm256_broadcast_ss(a + i);
+            acc[i][0] = _mm256_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm256_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 16;
+    }
+    __m256 scale = _mm256_set1_ps(alpha);
+#pragma GCC unroll 6
+    for (size_t i = 0; i < MR; ++i) {
+        float* row = c + i * ldc;
+        _mm256_storeu_ps(row, _mm256_fmadd_ps(scale, acc[i][0], _mm256_loadu_ps(row)));
+        _mm256_storeu_ps(row + 8, _mm256_fmadd_ps(scale, acc[i][1], _mm256_loadu_ps(row + 8)));
+    }
+}
+
+__attribute__((target("avx512f")))
+void kernelAvx512(size_t kc, const double* a, const double* b,
+                  double* c, size_t ldc, double alpha) {
+    constexpr size_t MR = 8;
+    __m512d acc[MR][2];
+#pragma GCC unroll 8
+    for (size_t i = 0; i < MR; ++i) {
+        acc[i][0] = _mm512_setzero_pd();
+        acc[i][1] = _mm512_setzero_pd();
+    }
+    for (size_t p = 0; p < kc; ++p) {
+        __m512d b0 = _mm512_loadu_pd(b);
+        __m512d b1 = _mm512_loadu_pd(b + 8);
+#pragma GCC unroll 8
+        for (size_t i = 0; i < MR; ++i) {
+            __m512d ai = _mm512_set1_pd(a[i]);
+            acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 16;
+    }
+    __m512d scale = _mm512_set1_pd(alpha);
+#pragma GCC unroll 8
+    for (size_t i = 0; i < MR; ++i) {
+        double* row = c + i * ldc;
+        _mm512_storeu_pd(row, _mm512_fmadd_pd(scale, acc[i][0], _mm512_loadu_pd(row)));
+        _mm512_storeu_pd(row + 8, _mm512_fmadd_pd(scale, acc[i][1], _mm512_loadu_pd(row + 8)));
+    }
+}
+
+__attribute__((target("avx512f")))
+void kernelAvx512(size_t kc, const float* a, const float* b,
+                  float* c, size_t ldc, float alpha) {
+    constexpr size_t MR = 8;
+    __m512 acc[MR][2];
+#pragma GCC unroll 8
+    for (size_t i = 0; i < MR; ++i) {
+        acc[i][0] = _mm512_setzero_ps();
+        acc[i][1] = _mm512_setzero_ps();
+    }
+    for (size_t p = 0; p < kc; ++p) {
+        __m512 b0 = _mm512_loadu_ps(b);
+        __m512 b1 = _mm512_loadu_ps(b + 16);
+#pragma GCC unroll 8
+        for (size_t i = 0; i < MR; ++i) {
+            __m512 ai = _mm512_set1_ps(a[i]);
+            acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+            acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+        }
+        a += MR;
+        b += 32;
+    }
+    __m512 scale = _mm512_set1_ps(alpha);
+#pragma GCC unroll 8
+    for (size_t i = 0; i < MR; ++i) {
+        float* row = c + i * ldc;
+        _mm512_storeu_ps(row, _mm512_fmadd_ps(scale, acc[i][0], _mm512_loadu_ps(row)));
+        _mm512_storeu_ps(row + 16, _mm512_fmadd_ps(scale, acc[i][1], _mm512_loadu_ps(row + 16)));
+    }
+}
+#endif
+
+// Register tiles are sized to the vector width of each instruction set, so
+// float tiles are twice as wide as double tiles.
+template <typename T>
+const KernelInfo<T>& kernelInfo(GemmKernel family) {
+    static const KernelInfo<T> scalar{"scalar", kernelScalar<T>, 4, 4, 96, 256, 4096};
+#ifdef ML_GEMM_X86
+    constexpr size_t lanes = 32 / sizeof(T);
+    static const KernelInfo<T> avx2{"avx2", kernelAvx2, 6, 2 * lanes, 96, 256, 4096};
+    static const KernelInfo<T> avx512{"avx512", kernelAvx512, 8, 4 * lanes, 96, 256, 4096};
+    if (family == GemmKernel::AVX512) {
+        return avx512;
+    }
+    if (family == GemmKernel::AVX2) {
+        return avx2;
+    }
+#endif
+    return scalar;
+}
+
+bool cpuSupports(GemmKernel family) {
+#ifdef ML_GEMM_X86
+    __builtin_cpu_init();
+    if (family == GemmKernel::AVX512) {
+        return __builtin_cpu_supports("avx512f");
+    }
+    if (family == GemmKernel::AVX2) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+#endif
+    return family == GemmKernel::Scalar;
+}
+
+GemmKernel detectKernel() {
+    if (cpuSupports(GemmKernel::AVX512)) {
+        return GemmKernel::AVX512;
+    }
+    if (cpuSupports(GemmKernel::AVX2)) {
+        return GemmKernel::AVX2;
+    }
+    return GemmKernel::Scalar;
+}
+
+std::atomic<GemmKernel> activeKernel{detectKernel()};
+
+// Strided read-only access to op(M) without materializing the transpose
+template <typename T>
+struct Operand {
+    const T* data;
+    size_t ld;
+    bool trans;
+
+    T operator()(size_t i, size_t j) const {
+        return trans ? data[j * ld + i] : data[i * ld + j];
+    }
+};
+
+// Pack rows [ic, ic+mc) x depth [pc, pc+kc) of op(A) into mr-row panels,
+// zero-padding the last panel.
+template <typename T>
+void packA(const Operand<T>& A, size_t ic, size_t pc, size_t mc, size_t kc,
+           size_t mr, T* out) {
+    for (size_t ir = 0; ir < mc; ir += mr) {
+        size_t rows = std::min(mr, mc - ir);
+        for (size_t p = 0; p < kc; ++p) {
+            if (A.trans) {
+                // A stored transposed: the panel column is contiguous
+                const T* src = A.data + (pc + p) * A.ld + ic + ir;
+                std::copy(src, src + rows, out);
+            } else {
+                const T* src = A.data + (ic + ir) * A.ld + pc + p;
+                for (size_t i = 0; i < rows; ++i) {
+                    out[i] = src[i * A.ld];
+                }
+            }
+            for (size_t i = rows; i < mr; ++i) {
+                out[i] = T(0);
+            }
+            out += mr;
+        }
+    }
+}
+
+// Pack depth [pc, pc+kc) x columns [jc, jc+nc) of op(B) into nr-column
+// panels, zero-padding the last panel.
+template <typename T>
+void packB(const Operand<T>& B, size_t pc, size_t jc, size_t kc, size_t nc,
+           size_t nr, T* out) {
+    for (size_t jr = 0; jr < nc; jr += nr) {
+        size_t cols = std::min(nr, nc - jr);
+        for (size_t p = 0; p < kc; ++p) {
+            if (!B.trans) {
+                const T* src = B.data + (pc + p) * B.ld + jc + jr;
+                std::copy(src, src + cols, out);
+            } else {
+                for (size_t j = 0; j < cols; ++j) {
+                    out[j] = B(pc + p, jc + jr + j);
+                }
+            }
+            for (size_t j = cols; j < nr; ++j) {
+                out[j] = T(0);
+            }
+            out += nr;
+        }
+    }
+}
+
+template <typename T>
+void scaleOutput(T* c, size_t ldc, size_t m, size_t n, T beta) {
+    if (beta == 1.0) {
+        return;
+    }
+    for (size_t i = 0; i < m; ++i) {
+        T* row = c + i * ldc;
+        if (beta == T(0)) {
+            std::fill(row, row + n, T(0));
+        } else {
+            for (size_t j = 0; j < n; ++j) {
+                row[j] *= beta;
+            }
+        }
+    }
+}
+
+// Multiply a packed mc x kc block of A by packed B micro-panels
+// [jrBegin, jrEnd) (in columns) and accumulate into cBlock.
+template <typename T>
+void macroKernel(const KernelInfo<T>& info, T alpha, const T* packedA,
+                 const T* packedB, size_t mc, size_t nc, size_t kc,
+                 size_t jrBegin, size_t jrEnd, T* cBlock, size_t ldc) {
+    const size_t mr = info.mr;
+    const size_t nr = info.nr;
+    T edge[kMaxTile];
+
+    for (size_t jr = jrBegin; jr < jrEnd; jr += nr) {
+        size_t cols = std::min(nr, nc - jr);
+        const T* bPanel = packedB + jr * kc;
+        for (size_t ir = 0; ir < mc; ir += mr) {
+            size_t rows = std::min(mr, mc - ir);
+            const T* aPanel = packedA + ir * kc;
+            T* cTile = cBlock + ir * ldc + jr;
+
+            if (rows == mr && cols == nr) {
+                info.kernel(kc, aPanel, bPanel, cTile, ldc, alpha);
+            } else {
+                // Partial tile: run the full kernel into scratch
+                std::fill(edge, edge + mr * nr, T(0));
+                info.kernel(kc, aPanel, bPanel, edge, nr, alpha);
+                for (size_t i = 0; i < rows; ++i) {
+                    for (size_t j = 0; j < cols; ++j) {
+                        cTile[i * ldc + j] += edge[i * nr + j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Packed GEMM over the full depth. Work is split across threads by row
+// blocks of A, or by micro-panels of B when A fits in a single block; each
+// element of C is produced by exactly one thread either way.
+template <typename T>
+void gemmBlocked(const KernelInfo<T>& info, T alpha, const Operand<T>& A,
+                 const Operand<T>& B, size_t m, size_t n, size_t k,
+                 T* c, size_t ldc) {
+    const size_t mr = info.mr;
+    const size_t nr = info.nr;
+
+    thread_local Buffer<T> packedB;
+    packedB.resize(((info.nc + nr - 1) / nr) * nr * info.kc);
+
+    auto packedABuffer = [&info]() -> T* {
+        thread_local Buffer<T> packedA;
+        packedA.resize(info.mc * info.kc);
+        return packedA.data();
+    };
+
+    const size_t rowBlocks = (m + info.mc - 1) / info.mc;
+
+    for (size_t jc = 0; jc < n; jc += info.nc) {
+        size_t nc = std::min(info.nc, n - jc);
+        for (size_t pc = 0; pc < k; pc += info.kc) {
+            size_t kc = std::min(info.kc, k - pc);
+            packB(B, pc, jc, kc, nc, nr, packedB.data());
+            const T* bPacked = packedB.data();
+
+            if (rowBlocks > 1) {
+                parallelFor(0, rowBlocks, 1, [&](size_t lo, size_t hi) {
+                    T* aPacked = packedABuffer();
+                    for (size_t block = lo; block < hi; ++block) {
+                        size_t ic = block * info.mc;
+                        size_t mc = std::min(info.mc, m - ic);
+                        packA(A, ic, pc, mc, kc, mr, aPacked);
+                        macroKernel(info, alpha, aPacked, bPacked, mc, nc, kc,
+                                    0, nc, c + ic * ldc + jc, ldc);
+                    }
+                });
+            } else {
+                T* aPacked = packedABuffer();
+                packA(A, 0, pc, m, kc, mr, aPacked);
+                const size_t panels = (nc + nr - 1) / nr;
+                // Keep each chunk to at least ~4 micro-panels of work
+                parallelFor(0, panels, 4, [&](size_t lo, size_t hi) {
+                    macroKernel(info, alpha, aPacked, bPacked, m, nc, kc,
+                                lo * nr, std::min(nc, hi * nr), c + jc, ldc);
+                });
+            }
+        }
+    }
+}
+
+// Small, deep products (e.g. X^T X on tall data) have too few output blocks
+// to share out, so split the depth instead: each chunk accumulates into its
+// own partial result and the partials are summed in chunk order, which keeps
+// the result independent of scheduling.
+template <typename T>
+void gemmSplitDepth(const KernelInfo<T>& info, T alpha, const Operand<T>& A,
+                    const Operand<T>& B, size_t m, size_t n, size_t k,
+                    size_t chunks, T* c, size_t ldc) {
+    std::vector<Buffer<T>> partials(chunks, Buffer<T>(m * n, T(0)));
+
+    parallelFor(0, chunks, 1, [&](size_t lo, size_t hi) {
+        ThreadLimit serial(1);
+        for (size_t chunk = lo; chunk < hi; ++chunk) {
+            size_t p0 = k * chunk / chunks;
+            size_t p1 = k * (chunk + 1) / chunks;
+            Operand<T> subA = A;
+            subA.data += A.trans ? p0 * A.ld : p0;
+            Operand<T> subB = B;
+            subB.data += B.trans ? p0 : p0 * B.ld;
+            gemmBlocked(info, alpha, subA, subB, m, n, p1 - p0, partials[chunk].data(), n);
+        }
+    });
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        const T* partial = partials[chunk].data();
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                c[i * ldc + j] += partial[i * n + j];
+            }
+        }
+    }
+}
+
+// Below this many multiply-adds packing costs more than it saves
+constexpr size_t kSmallGemmFlops = 4096;
+
+template <typename T>
+void gemmSmall(T alpha, const Operand<T>& A, const Operand<T>& B,
+               size_t m, size_t n, size_t k, T* c, size_t ldc) {
+    for (size_t i = 0; i < m; ++i) {
+        T* out = c + i * ldc;
+        for (size_t p = 0; p < k; ++p) {
+            T a = alpha * A(i, p);
+            if (!B.trans) {
+                const T* b = B.data + p * B.ld;
+                for (size_t j = 0; j < n; ++j) {
+                    out[j] += a * b[j];
+                }
+            } else {
+                for (size_t j = 0; j < n; ++j) {
+                    out[j] += a * B(p, j);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+template <typename T>
+void gemmImpl(size_t m, size_t n, size_t k, T alpha,
+              const T* A, size_t lda, Transpose transA,
+              const T* B, size_t ldb, Transpose transB,
+              T beta, T* C, size_t ldc) {
+    scaleOutput(C, ldc, m, n, beta);
+
+    if (m == 0 || n == 0 || k == 0 || alpha == T(0)) {
+        return;
+    }
+
+    Operand<T> opA{A, lda, transA == Transpose::Yes};
+    Operand<T> opB{B, ldb, transB == Transpose::Yes};
+
+    if (m * n * k < kSmallGemmFlops) {
+        gemmSmall(alpha, opA, opB, m, n, k, C, ldc);
+        return;
+    }
+
+    const KernelInfo<T>& info = kernelInfo<T>(activeKernel.load(std::memory_order_relaxed));
+    const bool fewOutputBlocks = m <= info.mc && n <= info.nc;
+    if (fewOutputBlocks && k >= 4 * info.kc) {
+        size_t chunks = ThreadPool::instance().chunkCount(k, 2 * info.kc);
+        if (chunks > 1) {
+            gemmSplitDepth(info, alpha, opA, opB, m, n, k, chunks, C, ldc);
+            return;
+        }
+    }
+
+    gemmBlocked(info, alpha, opA, opB, m, n, k, C, ldc);
+}
+
+template <typename T>
+void gemmImpl(T alpha, const BasicMatrix<T>& A, Transpose transA,
+              const BasicMatrix<T>& B, Transpose transB,
+              T beta, BasicMatrix<T>& C) {
+    const bool ta = transA == Transpose::Yes;
+    const bool tb = transB == Transpose::Yes;
+    const size_t m = ta ? A.cols() : A.rows();
+    const size_t k = ta ? A.rows() : A.cols();
+    const size_t kb = tb ? B.cols() : B.rows();
+    const size_t n = tb ? B.rows() : B.cols();
+
+    if (k != kb) {
+        throw std::invalid_argument("Invalid dimensions for matrix multiplication");
+    }
+
+    if (&C == &A || &C == &B) {
+        // Output aliases an input: compute into a temporary and swap in
+        BasicMatrix<T> result = (beta == T(0)) ? BasicMatrix<T>(m, n) : C;
+        gemmImpl(alpha, A, transA, B, transB, beta, result);
+        C = std::move(result);
+        return;
+    }
+
+    if (C.rows() != m || C.cols() != n) {
+        if (beta != T(0)) {
+            throw std::invalid_argument("Output matrix has wrong dimensions for gemm");
+        }
+        C = BasicMatrix<T>(m, n);
+    }
+
+    gemmImpl(m, n, k, alpha, A.data(), A.stride(), transA, B.data(), B.stride(), transB,
+             beta, C.data(), C.stride());
+}
+
+void gemm(double alpha, const Matrix& A, Transpose transA,
+          const Matrix& B, Transpose transB,
+          double beta, Matrix& C) {
+    gemmImpl(alpha, A, transA, B, transB, beta, C);
+}
+
+void gemm(float alpha, const MatrixF& A, Transpose transA,
+          const MatrixF& B, Transpose transB,
+          float beta, MatrixF& C) {
+    gemmImpl(alpha, A, transA, B, transB, beta, C);
+}
+
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t lda, Transpose transA,
+          const double* B, size_t ldb, Transpose transB,
+          double beta, double* C, size_t ldc) {
+    gemmImpl(m, n, k, alpha, A, lda, transA, B, ldb, transB, beta, C, ldc);
+}
+
+void gemm(size_t m, size_t n, size_t k, float alpha,
+          const float* A, size_t lda, Transpose transA,
+          const float* B, size_t ldb, Transpose transB,
+          float beta, float* C, size_t ldc) {
+    gemmImpl(m, n, k, alpha, A, lda, transA, B, ldb, transB, beta, C, ldc);
+}
+
+void setGemmKernel(GemmKernel kernel) {
+    if (kernel == GemmKernel::Auto) {
+        kernel = detectKernel();
+    } else if (!cpuSupports(kernel)) {
+        kernel = GemmKernel::Scalar;
+    }
+    activeKernel.store(kernel, std::memory_order_relaxed);
+}
+
+const char* gemmKernelName() {
+    return kernelInfo<double>(activeKernel.load(std::memory_order_relaxed)).name;
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
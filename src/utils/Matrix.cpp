@@ -1,25 +1,44 @@
 #include "utils/Matrix.hpp"
+#include "utils/Decomposition.hpp"
+#include "utils/Gemm.hpp"
+#include "utils/ThreadPool.hpp"
 #include <cmath>
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <type_traits>
 
 namespace ml {
 namespace utils {
 
-Matrix::Matrix(size_t rows, size_t cols) 
-    : rows_(rows), cols_(cols), data_(rows, std::vector<double>(cols, 0.0)) {}
+namespace {
 
-Matrix::Matrix(const std::vector<std::vector<double>>& data) {
+const Matrix& asDouble(const Matrix& matrix) {
+    return matrix;
+}
+
+Matrix asDouble(const MatrixF& matrix) {
+    return matrix.cast<double>();
+}
+
+} // namespace
+
+template <typename T>
+BasicMatrix<T>::BasicMatrix(size_t rows, size_t cols) 
+    : rows_(rows), cols_(cols), stride_(cols), data_(rows * cols, T(0)) {}
+
+template <typename T>
+BasicMatrix<T>::BasicMatrix(const std::vector<std::vector<T>>& data) {
     if (data.empty()) {
         rows_ = 0;
         cols_ = 0;
+        stride_ = 0;
         return;
     }
     
     rows_ = data.size();
     cols_ = data[0].size();
-    data_ = data;
+    stride_ = cols_;
 
     // Validate all rows have same length
     for (const auto& row : data) {
@@ -27,286 +46,208 @@ Matrix::Matrix(const std::vector<std::vector<double>>& data) {
             throw std::invalid_argument("Inconsistent row sizes in input data");
         }
     }
+
+    data_.resize(rows_ * cols_);
+    for (size_t i = 0; i < rows_; ++i) {
+        std::copy(data[i].begin(), data[i].end(), rowPtr(i));
+    }
 }
 
-Matrix::Matrix(const Matrix& other)
-    : rows_(other.rows_), cols_(other.cols_), data_(other.data_) {}
+template <typename T>
+BasicMatrix<T>::BasicMatrix(const BasicMatrix& other)
+    : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_), data_(other.data_) {}
 
-Matrix::Matrix(Matrix&& other) noexcept
-    : rows_(other.rows_), cols_(other.cols_), data_(std::move(other.data_)) {
+template <typename T>
+BasicMatrix<T>::BasicMatrix(BasicMatrix&& other) noexcept
+    : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_),
+      data_(std::move(other.data_)) {
     other.rows_ = 0;
     other.cols_ = 0;
+    other.stride_ = 0;
 }
 
-Matrix& Matrix::operator=(const Matrix& other) {
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator=(const BasicMatrix& other) {
     if (this != &other) {
         rows_ = other.rows_;
         cols_ = other.cols_;
+        stride_ = other.stride_;
         data_ = other.data_;
     }
     return *this;
 }
 
-Matrix& Matrix::operator=(Matrix&& other) noexcept {
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator=(BasicMatrix&& other) noexcept {
     if (this != &other) {
         rows_ = other.rows_;
         cols_ = other.cols_;
+        stride_ = other.stride_;
         data_ = std::move(other.data_);
         other.rows_ = 0;
         other.cols_ = 0;
+        other.stride_ = 0;
     }
     return *this;
 }
 
-Matrix Matrix::operator+(const Matrix& other) const {
-    validateDimensions(other);
-    Matrix result(rows_, cols_);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            result.data_[i][j] = data_[i][j] + other.data_[i][j];
-        }
-    }
-    return result;
-}
-
-Matrix Matrix::operator-(const Matrix& other) const {
-    validateDimensions(other);
-    Matrix result(rows_, cols_);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            result.data_[i][j] = data_[i][j] - other.data_[i][j];
-        }
-    }
-    return result;
-}
-
-Matrix Matrix::operator*(const Matrix& other) const {
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::operator*(const BasicMatrix& other) const {
     if (cols_ != other.rows_) {
         throw std::invalid_argument("Invalid dimensions for matrix multiplication");
     }
     
-    Matrix result(rows_, other.cols_);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < other.cols_; ++j) {
-            double sum = 0.0;
-            for (size_t k = 0; k < cols_; ++k) {
-                sum += data_[i][k] * other.data_[k][j];
-            }
-            result.data_[i][j] = sum;
-        }
-    }
+    BasicMatrix result(rows_, other.cols_);
+    gemm(T(1), *this, Transpose::No, other, Transpose::No, T(0), result);
     return result;
 }
 
-Matrix Matrix::operator*(double scalar) const {
-    Matrix result(rows_, cols_);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            result.data_[i][j] = data_[i][j] * scalar;
-        }
-    }
-    return result;
-}
-
-Matrix& Matrix::operator+=(const Matrix& other) {
-    validateDimensions(other);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            data_[i][j] += other.data_[i][j];
-        }
-    }
-    return *this;
-}
-
-Matrix& Matrix::operator-=(const Matrix& other) {
-    validateDimensions(other);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            data_[i][j] -= other.data_[i][j];
-        }
-    }
-    return *this;
-}
-
-Matrix& Matrix::operator*=(double scalar) {
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            data_[i][j] *= scalar;
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator*=(T scalar) {
+    detail::forRows(rows_, cols_, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            T* a = rowPtr(i);
+            for (size_t j = 0; j < cols_; ++j) {
+                a[j] *= scalar;
+            }
         }
-    }
+    });
     return *this;
 }
 
-std::vector<double>& Matrix::operator[](size_t row) {
+template <typename T>
+Span<T> BasicMatrix<T>::operator[](size_t row) {
     if (row >= rows_) {
         throw std::out_of_range("Row index out of range");
     }
-    return data_[row];
+    return Span<T>(rowPtr(row), cols_);
 }
 
-const std::vector<double>& Matrix::operator[](size_t row) const {
+template <typename T>
+Span<const T> BasicMatrix<T>::operator[](size_t row) const {
     if (row >= rows_) {
         throw std::out_of_range("Row index out of range");
     }
-    return data_[row];
-}
-
-Matrix Matrix::transpose() const {
-    Matrix result(cols_, rows_);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            result.data_[j][i] = data_[i][j];
+    return Span<const T>(rowPtr(row), cols_);
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::transpose() const {
+    BasicMatrix result(cols_, rows_);
+
+    // Tiled so that both the reads and the writes stay within a few cache
+    // lines; threads own disjoint bands of output rows.
+    constexpr size_t tile = 32;
+    const size_t bands = (cols_ + tile - 1) / tile;
+    auto transposeBands = [&](size_t lo, size_t hi) {
+        for (size_t band = lo; band < hi; ++band) {
+            size_t j0 = band * tile;
+            size_t j1 = std::min(cols_, j0 + tile);
+            for (size_t i0 = 0; i0 < rows_; i0 += tile) {
+                size_t i1 = std::min(rows_, i0 + tile);
+                for (size_t j = j0; j < j1; ++j) {
+                    T* out = result.rowPtr(j);
+                    for (size_t i = i0; i < i1; ++i) {
+                        out[i] = (*this)(i, j);
+                    }
+                }
+            }
         }
+    };
+
+    if (rows_ * cols_ < detail::kParallelElements) {
+        transposeBands(0, bands);
+    } else {
+        parallelFor(0, bands, 1, transposeBands);
     }
     return result;
 }
 
-Matrix Matrix::inverse() const {
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::inverse() const {
     if (rows_ != cols_) {
         throw std::invalid_argument("Matrix must be square for inverse");
     }
     
-    // Implement Gauss-Jordan elimination
-    Matrix augmented(rows_, 2 * cols_);
-    
-    // Create augmented matrix [A|I]
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            augmented.data_[i][j] = data_[i][j];
-            augmented.data_[i][j + cols_] = (i == j) ? 1.0 : 0.0;
-        }
-    }
-    
-    // Gaussian elimination
-    for (size_t i = 0; i < rows_; ++i) {
-        double pivot = augmented.data_[i][i];
-        if (std::abs(pivot) < 1e-10) {
-            throw std::runtime_error("Matrix is singular");
-        }
-        
-        // Scale pivot row
-        for (size_t j = 0; j < 2 * cols_; ++j) {
-            augmented.data_[i][j] /= pivot;
-        }
-        
-        // Eliminate column
-        for (size_t k = 0; k < rows_; ++k) {
-            if (k != i) {
-                double factor = augmented.data_[k][i];
-                for (size_t j = 0; j < 2 * cols_; ++j) {
-                    augmented.data_[k][j] -= factor * augmented.data_[i][j];
-                }
-            }
-        }
+    // Factorize in double regardless of T
+    LUDecomposition lu(asDouble(*this));
+    if (lu.isSingular()) {
+        throw std::runtime_error("Matrix is singular");
     }
-    
-    // Extract inverse from augmented matrix
-    Matrix inverse(rows_, cols_);
-    for (size_t i = 0; i < rows_; ++i) {
-        for (size_t j = 0; j < cols_; ++j) {
-            inverse.data_[i][j] = augmented.data_[i][j + cols_];
-        }
+    if constexpr (std::is_same<T, double>::value) {
+        return lu.inverse();
+    } else {
+        return lu.inverse().template cast<T>();
     }
-    
-    return inverse;
 }
 
-double Matrix::determinant() const {
+template <typename T>
+double BasicMatrix<T>::determinant() const {
     if (rows_ != cols_) {
         throw std::invalid_argument("Matrix must be square for determinant");
     }
     
-    if (rows_ == 1) {
-        return data_[0][0];
-    }
-    
-    if (rows_ == 2) {
-        return data_[0][0] * data_[1][1] - data_[0][1] * data_[1][0];
-    }
-    
-    double det = 0.0;
-    for (size_t j = 0; j < cols_; ++j) {
-        Matrix minor(rows_ - 1, cols_ - 1);
-        for (size_t i = 1; i < rows_; ++i) {
-            size_t k = 0;
-            for (size_t l = 0; l < cols_; ++l) {
-                if (l != j) {
-                    minor.data_[i-1][k] = data_[i][l];
-                    ++k;
-                }
-            }
-        }
-        det += (j % 2 == 0 ? 1 : -1) * data_[0][j] * minor.determinant();
-    }
-    return det;
+    return LUDecomposition(asDouble(*this)).determinant();
 }
 
-Matrix Matrix::identity(size_t size) {
-    Matrix result(size, size);
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::identity(size_t size) {
+    BasicMatrix result(size, size);
     for (size_t i = 0; i < size; ++i) {
-        result.data_[i][i] = 1.0;
+        result(i, i) = T(1);
     }
     return result;
 }
 
-Matrix Matrix::zeros(size_t rows, size_t cols) {
-    return Matrix(rows, cols);
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::zeros(size_t rows, size_t cols) {
+    return BasicMatrix(rows, cols);
 }
 
-Matrix Matrix::ones(size_t rows, size_t cols) {
-    Matrix result(rows, cols);
-    for (auto& row : result.data_) {
-        std::fill(row.begin(), row.end(), 1.0);
-    }
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::ones(size_t rows, size_t cols) {
+    BasicMatrix result(rows, cols);
+    std::fill(result.data_.begin(), result.data_.end(), T(1));
     return result;
 }
 
-void Matrix::reshape(size_t rows, size_t cols) {
+template <typename T>
+void BasicMatrix<T>::reshape(size_t rows, size_t cols) {
     if (rows * cols != rows_ * cols_) {
         throw std::invalid_argument("New dimensions must preserve total size");
     }
-    
-    std::vector<double> temp;
-    temp.reserve(rows_ * cols_);
-    
-    for (const auto& row : data_) {
-        temp.insert(temp.end(), row.begin(), row.end());
-    }
-    
-    data_.resize(rows);
-    for (auto& row : data_) {
-        row.resize(cols);
-    }
-    
-    size_t k = 0;
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            data_[i][j] = temp[k++];
-        }
-    }
-    
+
+    // Storage is dense (stride == cols), so only the shape metadata changes
     rows_ = rows;
     cols_ = cols;
+    stride_ = cols;
 }
 
-void Matrix::validateDimensions(const Matrix& other) const {
+template <typename T>
+void BasicMatrix<T>::validateDimensions(const BasicMatrix& other) const {
     if (rows_ != other.rows_ || cols_ != other.cols_) {
         throw std::invalid_argument("Matrix dimensions must match");
     }
 }
 
-std::ostream& operator<<(std::ostream& os, const Matrix& matrix) {
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const BasicMatrix<T>& matrix) {
     os << std::fixed << std::setprecision(4);
-    for (size_t i = 0; i < matrix.rows_; ++i) {
+    for (size_t i = 0; i < matrix.rows(); ++i) {
         os << "[";
-        for (size_t j = 0; j < matrix.cols_; ++j) {
-            os << std::setw(8) << matrix.data_[i][j];
-            if (j < matrix.cols_ - 1) os << ", ";
+        for (size_t j = 0; j < matrix.cols(); ++j) {
+            os << std::setw(8) << matrix(i, j);
+            if (j < matrix.cols() - 1) os << ", ";
         }
         os << "]\n";
     }
     return os;
 }
 
+template class BasicMatrix<float>;
+template class BasicMatrix<double>;
+template std::ostream& operator<<(std::ostream&, const BasicMatrix<float>&);
+template std::ostream& operator<<(std::ostream&, const BasicMatrix<double>&);
+
 } // namespace utils
 } // namespace ml
\ No newline at end of file
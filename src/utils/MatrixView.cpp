@@ -0,0 +1,80 @@
+#include "utils/MatrixView.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace ml {
+namespace utils {
+
+template <typename T>
+BasicMatrixView<T>::BasicMatrixView()
+    : data_(nullptr), rows_(0), cols_(0), stride_(0) {}
+
+template <typename T>
+BasicMatrixView<T>::BasicMatrixView(const BasicMatrix<T>& matrix)
+    : data_(matrix.data()), rows_(matrix.rows()), cols_(matrix.cols()),
+      stride_(matrix.stride()) {}
+
+template <typename T>
+BasicMatrixView<T>::BasicMatrixView(const T* data, size_t rows, size_t cols, size_t stride)
+    : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+
+template <typename T>
+Span<const T> BasicMatrixView<T>::operator[](size_t row) const {
+    if (row >= rows_) {
+        throw std::out_of_range("Row index out of range");
+    }
+    return Span<const T>(rowPtr(row), cols_);
+}
+
+template <typename T>
+BasicMatrixView<T> BasicMatrixView<T>::block(size_t rowBegin, size_t rowCount,
+                             size_t colBegin, size_t colCount) const {
+    if (rowBegin + rowCount > rows_ || colBegin + colCount > cols_) {
+        throw std::out_of_range("Block exceeds view dimensions");
+    }
+
+    BasicMatrixView result(*this);
+    result.data_ = data_ + colBegin;
+    result.rows_ = rowCount;
+    result.cols_ = colCount;
+    if (indices_) {
+        result.indices_ = std::make_shared<const std::vector<size_t>>(
+            indices_->begin() + rowBegin, indices_->begin() + rowBegin + rowCount);
+    } else {
+        result.data_ += rowBegin * stride_;
+    }
+    return result;
+}
+
+template <typename T>
+BasicMatrixView<T> BasicMatrixView<T>::selectRows(std::vector<size_t> rowIndices) const {
+    for (size_t& index : rowIndices) {
+        if (index >= rows_) {
+            throw std::out_of_range("Row index out of range");
+        }
+        // Compose with an existing gather so indices always address data_
+        if (indices_) {
+            index = (*indices_)[index];
+        }
+    }
+
+    BasicMatrixView result(*this);
+    result.rows_ = rowIndices.size();
+    result.indices_ = std::make_shared<const std::vector<size_t>>(std::move(rowIndices));
+    return result;
+}
+
+std::vector<double> gather(const std::vector<double>& values, const std::vector<size_t>& indices) {
+    std::vector<double> result;
+    result.reserve(indices.size());
+    for (size_t index : indices) {
+        result.push_back(values.at(index));
+    }
+    return result;
+}
+
+template class BasicMatrixView<float>;
+template class BasicMatrixView<double>;
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "utils/SparseMatrix.hpp"
+#include "utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace ml {
+namespace utils {
+
+namespace {
+
+// Nonzeros per chunk before row-parallel kernels are split across threads
+constexpr size_t kParallelNonZeros = size_t(1) << 15;
+
+} // namespace
+
+SparseMatrix::SparseMatrix()
+    : rows_(0), cols_(0), layout_(Layout::CSR), offsets_(1, 0) {}
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols, Layout layout)
+    : rows_(rows), cols_(cols), layout_(layout),
+      offsets_((layout == Layout::CSR ? rows : cols) + 1, 0) {}
+
+SparseMatrix::SparseMatrix(size_t rows, size_t cols,
+                           std::vector<size_t> offsets,
+                           std::vector<size_t> indices,
+                           std::vector<double> values,
+                           Layout layout)
+    : rows_(rows), cols_(cols), layout_(layout), offsets_(std::move(offsets)),
+      indices_(std::move(indices)), values_(std::move(values)) {
+    const size_t outer = outerSize();
+    const size_t inner = layout_ == Layout::CSR ? cols_ : rows_;
+
+    if (offsets_.size() != outer + 1 || offsets_.front() != 0) {
+        throw std::invalid_argument("Sparse offsets must have one entry per outer slice plus one, starting at 0");
+    }
+    if (indices_.size() != values_.size() || offsets_.back() != indices_.size()) {
+        throw std::invalid_argument("Sparse index and value arrays must match the offsets");
+    }
+    for (size_t o = 0; o < outer; ++o) {
+        if (offsets_[o] > offsets_[o + 1]) {
+            throw std::invalid_argument("Sparse offsets must be non-decreasing");
+        }
+        for (size_t p = offsets_[o]; p < offsets_[o + 1]; ++p) {
+            if (indices_[p] >= inner) {
+                throw std::out_of_range("Sparse index out of range");
+            }
+            if (p > offsets_[o] && indices_[p] <= indices_[p - 1]) {
+                throw std::invalid_argument("Sparse indices must be sorted and unique within a slice");
+            }
+        }
+    }
+}
+
+SparseMatrix SparseMatrix::fromTriplets(size_t rows, size_t cols,
+                                        const std::vector<Triplet>& triplets) {
+    std::vector<Triplet> sorted(triplets);
+    for (const Triplet& t : sorted) {
+        if (t.row >= rows || t.col >= cols) {
+            throw std::out_of_range("Triplet index out of range");
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Triplet& a, const Triplet& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+
+    SparseMatrix result(rows, cols);
+    result.indices_.reserve(sorted.size());
+    result.values_.reserve(sorted.size());
+    for (size_t p = 0; p < sorted.size(); ++p) {
+        const Triplet& t = sorted[p];
+        if (p > 0 && t.row == sorted[p - 1].row && t.col == sorted[p - 1].col) {
+            result.values_.back() += t.value;
+            continue;
+        }
+        result.indices_.push_back(t.col);
+        result.values_.push_back(t.value);
+        ++result.offsets_[t.row + 1];
+    }
+    std::partial_sum(result.offsets_.begin(), result.offsets_.end(), result.offsets_.begin());
+    return result;
+}
+
+SparseMatrix SparseMatrix::fromDense(const MatrixView& dense, double tolerance) {
+    SparseMatrix result(dense.rows(), dense.cols());
+    for (size_t i = 0; i < dense.rows(); ++i) {
+        const double* row = dense.rowPtr(i);
+        for (size_t j = 0; j < dense.cols(); ++j) {
+            if (std::abs(row[j]) > tolerance) {
+                result.indices_.push_back(j);
+                result.values_.push_back(row[j]);
+            }
+        }
+        result.offsets_[i + 1] = result.indices_.size();
+    }
+    return result;
+}
+
+double SparseMatrix::density() const {
+    const size_t total = rows_ * cols_;
+    return total == 0 ? 0.0 : static_cast<double>(nonZeros()) / total;
+}
+
+double SparseMatrix::operator()(size_t row, size_t col) const {
+    if (row >= rows_ || col >= cols_) {
+        throw std::out_of_range("Matrix indices out of range");
+    }
+    const size_t outer = layout_ == Layout::CSR ? row : col;
+    const size_t inner = layout_ == Layout::CSR ? col : row;
+
+    auto first = indices_.begin() + offsets_[outer];
+    auto last = indices_.begin() + offsets_[outer + 1];
+    auto it = std::lower_bound(first, last, inner);
+    if (it == last || *it != inner) {
+        return 0.0;
+    }
+    return values_[static_cast<size_t>(it - indices_.begin())];
+}
+
+SparseMatrix SparseMatrix::transpose() const {
+    SparseMatrix result(*this);
+    std::swap(result.rows_, result.cols_);
+    result.layout_ = layout_ == Layout::CSR ? Layout::CSC : Layout::CSR;
+    return result;
+}
+
+SparseMatrix SparseMatrix::toCSR() const {
+    return layout_ == Layout::CSR ? *this : switchLayout();
+}
+
+SparseMatrix SparseMatrix::toCSC() const {
+    return layout_ == Layout::CSC ? *this : switchLayout();
+}
+
+SparseMatrix SparseMatrix::switchLayout() const {
+    const size_t outer = outerSize();
+    const size_t inner = layout_ == Layout::CSR ? cols_ : rows_;
+    const Layout target = layout_ == Layout::CSR ? Layout::CSC : Layout::CSR;
+
+    SparseMatrix result(rows_, cols_, target);
+    result.indices_.resize(nonZeros());
+    result.values_.resize(nonZeros());
+
+    // Counting sort on the inner index; walking the old outer slices in
+    // order leaves every new slice sorted
+    for (size_t index : indices_) {
+        ++result.offsets_[index + 1];
+    }
+    std::partial_sum(result.offsets_.begin(), result.offsets_.end(), result.offsets_.begin());
+
+    std::vector<size_t> next(result.offsets_.begin(), result.offsets_.begin() + inner);
+    for (size_t o = 0; o < outer; ++o) {
+        for (size_t p = offsets_[o]; p < offsets_[o + 1]; ++p) {
+            size_t dest = next[indices_[p]]++;
+            result.indices_[dest] = o;
+            result.values_[dest] = values_[p];
+        }
+    }
+    return result;
+}
+
+Matrix SparseMatrix::toDense() const {
+    Matrix result(rows_, cols_);
+    for (size_t o = 0; o < outerSize(); ++o) {
+        for (size_t p = offsets_[o]; p < offsets_[o + 1]; ++p) {
+            if (layout_ == Layout::CSR) {
+                result(o, indices_[p]) = values_[p];
+            } else {
+                result(indices_[p], o) = values_[p];
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<double> SparseMatrix::multiply(Span<const double> x) const {
+    std::vector<double> y(rows_);
+    multiply(x, y);
+    return y;
+}
+
+void SparseMatrix::multiply(Span<const double> x, Span<double> y) const {
+    if (x.size() != cols_) {
+        throw std::invalid_argument("Vector length must match the number of columns");
+    }
+    if (y.size() != rows_) {
+        throw std::invalid_argument("Output length must match the number of rows");
+    }
+
+    if (layout_ == Layout::CSC) {
+        std::fill(y.begin(), y.end(), 0.0);
+        // Scatter each column into y
+        for (size_t j = 0; j < cols_; ++j) {
+            const double xj = x[j];
+            if (xj == 0.0) continue;
+            for (size_t p = offsets_[j]; p < offsets_[j + 1]; ++p) {
+                y[indices_[p]] += values_[p] * xj;
+            }
+        }
+        return;
+    }
+
+    auto rowsKernel = [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            double sum = 0.0;
+            for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+                sum += values_[p] * x[indices_[p]];
+            }
+            y[i] = sum;
+        }
+    };
+
+    if (nonZeros() < kParallelNonZeros || rows_ == 0) {
+        rowsKernel(0, rows_);
+    } else {
+        size_t grain = std::max<size_t>(1, kParallelNonZeros * rows_ / nonZeros());
+        parallelFor(0, rows_, grain, rowsKernel);
+    }
+}
+
+Matrix SparseMatrix::multiply(const MatrixView& B) const {
+    if (B.rows() != cols_) {
+        throw std::invalid_argument("Matrix dimensions don't match for multiplication");
+    }
+
+    const size_t n = B.cols();
+    Matrix C(rows_, n);
+    if (layout_ == Layout::CSC) {
+        for (size_t k = 0; k < cols_; ++k) {
+            const double* bRow = B.rowPtr(k);
+            for (size_t p = offsets_[k]; p < offsets_[k + 1]; ++p) {
+                double* cRow = C.rowPtr(indices_[p]);
+                const double v = values_[p];
+                for (size_t j = 0; j < n; ++j) {
+                    cRow[j] += v * bRow[j];
+                }
+            }
+        }
+        return C;
+    }
+
+    // Each output row is a combination of the B rows selected by A's nonzeros
+    auto rowsKernel = [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            double* cRow = C.rowPtr(i);
+            for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+                const double* bRow = B.rowPtr(indices_[p]);
+                const double v = values_[p];
+                for (size_t j = 0; j < n; ++j) {
+                    cRow[j] += v * bRow[j];
+                }
+            }
+        }
+    };
+
+    const size_t work = nonZeros() * std::max<size_t>(n, 1);
+    if (work < kParallelNonZeros || rows_ == 0) {
+        rowsKernel(0, rows_);
+    } else {
+        size_t grain = std::max<size_t>(1, kParallelNonZeros * rows_ / work);
+        parallelFor(0, rows_, grain, rowsKernel);
+    }
+    return C;
+}
+
+Matrix SparseMatrix::gram() const {
+    if (layout_ == Layout::CSC) {
+        return toCSR().gram();
+    }
+
+    Matrix G(cols_, cols_);
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t p = offsets_[i]; p < offsets_[i + 1]; ++p) {
+            double* gRow = G.rowPtr(indices_[p]);
+            const double v = values_[p];
+            // Upper triangle only; indices are sorted so q >= p means col >= row
+            for (size_t q = p; q < offsets_[i + 1]; ++q) {
+                gRow[indices_[q]] += v * values_[q];
+            }
+        }
+    }
+    for (size_t a = 0; a < cols_; ++a) {
+        for (size_t b = 0; b < a; ++b) {
+            G(a, b) = G(b, a);
+        }
+    }
+    return G;
+}
+
+std::vector<double> SparseMatrix::rowSquaredNorms() const {
+    std::vector<double> norms(rows_, 0.0);
+    for (size_t o = 0; o < outerSize(); ++o) {
+        for (size_t p = offsets_[o]; p < offsets_[o + 1]; ++p) {
+            norms[layout_ == Layout::CSR ? o : indices_[p]] += values_[p] * values_[p];
+        }
+    }
+    return norms;
+}
+
+double sparseDot(Span<const size_t> aIndices, Span<const double> aValues,
+                 Span<const size_t> bIndices, Span<const double> bValues) {
+    double sum = 0.0;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < aIndices.size() && j < bIndices.size()) {
+        if (aIndices[i] < bIndices[j]) {
+            ++i;
+        } else if (bIndices[j] < aIndices[i]) {
+            ++j;
+        } else {
+            sum += aValues[i++] * bValues[j++];
+        }
+    }
+    return sum;
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
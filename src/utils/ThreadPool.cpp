@@ -0,0 +1,179 @@
+#include "utils/ThreadPool.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+
+namespace ml {
+namespace utils {
+
+namespace {
+
+thread_local bool insideWorker = false;
+thread_local size_t threadLimit = 0;
+
+size_t defaultThreadCount() {
+    if (const char* env = std::getenv("ML_NUM_THREADS")) {
+        long value = std::strtol(env, nullptr, 10);
+        if (value > 0) {
+            return static_cast<size_t>(value);
+        }
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Completion state shared between a parallelFor call and its chunks
+struct Batch {
+    size_t remaining = 0;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+};
+
+} // namespace
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool(defaultThreadCount());
+    return pool;
+}
+
+ThreadPool::ThreadPool(size_t numThreads) : stopping_(false) {
+    start(numThreads == 0 ? defaultThreadCount() : numThreads);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+void ThreadPool::setNumThreads(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = defaultThreadCount();
+    }
+    if (numThreads == this->numThreads()) {
+        return;
+    }
+    stop();
+    start(numThreads);
+}
+
+void ThreadPool::start(size_t numThreads) {
+    stopping_ = false;
+    workers_.reserve(numThreads - 1);
+    for (size_t i = 1; i < numThreads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+}
+
+void ThreadPool::workerLoop() {
+    insideWorker = true;
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stopping_ || nextTask_ < tasks_.size(); });
+        if (nextTask_ == tasks_.size()) {
+            return;
+        }
+        const Task task = tasks_[nextTask_++];
+        if (nextTask_ == tasks_.size()) {
+            tasks_.clear();
+            nextTask_ = 0;
+        }
+        lock.unlock();
+        task.run(task.chunk);
+    }
+}
+
+size_t ThreadPool::chunkCount(size_t count, size_t grain) const {
+    if (count == 0) {
+        return 0;
+    }
+    size_t threads = numThreads();
+    if (threadLimit > 0) {
+        threads = std::min(threads, threadLimit);
+    }
+    if (insideWorker) {
+        threads = 1;
+    }
+    size_t maxChunks = (count + std::max<size_t>(grain, 1) - 1) / std::max<size_t>(grain, 1);
+    return std::max<size_t>(1, std::min(threads, maxChunks));
+}
+
+void ThreadPool::parallelFor(size_t begin, size_t end, size_t grain,
+                             FunctionRef<void(size_t, size_t)> fn) {
+    if (end <= begin) {
+        return;
+    }
+    const size_t count = end - begin;
+    const size_t chunks = chunkCount(count, grain);
+    if (chunks == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    auto bounds = [&](size_t c) { return begin + count * c / chunks; };
+
+    Batch batch;
+    batch.remaining = chunks - 1;
+    auto runChunk = [&](size_t c) {
+        try {
+            fn(bounds(c), bounds(c + 1));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            if (!batch.error) {
+                batch.error = std::current_exception();
+            }
+        }
+    };
+
+    auto runTask = [&batch, &runChunk](size_t c) {
+        runChunk(c);
+        // Decrement under the lock so the caller cannot return and
+        // destroy the batch between our update and the notify
+        std::lock_guard<std::mutex> doneLock(batch.mutex);
+        if (--batch.remaining == 0) {
+            batch.done.notify_one();
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t c = 1; c < chunks; ++c) {
+            tasks_.push_back({runTask, c});
+        }
+    }
+    cv_.notify_all();
+
+    // The calling thread takes the first chunk itself
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.done.wait(lock, [&batch] { return batch.remaining == 0; });
+    if (batch.error) {
+        std::rethrow_exception(batch.error);
+    }
+}
+
+ThreadLimit::ThreadLimit(size_t maxThreads) : previous_(threadLimit) {
+    threadLimit = maxThreads;
+}
+
+ThreadLimit::~ThreadLimit() {
+    threadLimit = previous_;
+}
+
+size_t ThreadLimit::current() {
+    return threadLimit;
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file
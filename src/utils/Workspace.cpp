@@ -0,0 +1,77 @@
+#include "utils/Workspace.hpp"
+#include <new>
+
+namespace ml {
+namespace utils {
+
+namespace {
+
+thread_local Workspace* activeWorkspace = nullptr;
+
+} // namespace
+
+Workspace::Workspace(size_t maxCachedBytes) : maxCachedBytes_(maxCachedBytes) {}
+
+Workspace::~Workspace() {
+    release();
+}
+
+Workspace* Workspace::current() {
+    return activeWorkspace;
+}
+
+void* Workspace::allocate(size_t bytes) {
+    auto it = cache_.find(bytes);
+    if (it != cache_.end() && !it->second.empty()) {
+        void* ptr = it->second.back();
+        it->second.pop_back();
+        ++stats_.reused;
+        --stats_.cachedBlocks;
+        stats_.cachedBytes -= bytes;
+        return ptr;
+    }
+
+    ++stats_.heapAllocations;
+    return ::operator new(bytes, std::align_val_t(kAlignment));
+}
+
+void Workspace::deallocate(void* ptr, size_t bytes) noexcept {
+    if (stats_.cachedBytes + bytes <= maxCachedBytes_) {
+        try {
+            cache_[bytes].push_back(ptr);
+            ++stats_.cachedBlocks;
+            stats_.cachedBytes += bytes;
+            return;
+        } catch (...) {
+            // Could not grow the cache; fall through and free the block
+        }
+    }
+    ::operator delete(ptr, std::align_val_t(kAlignment));
+}
+
+void Workspace::release() {
+    for (auto& [bytes, blocks] : cache_) {
+        for (void* ptr : blocks) {
+            ::operator delete(ptr, std::align_val_t(kAlignment));
+        }
+    }
+    cache_.clear();
+    stats_.cachedBlocks = 0;
+    stats_.cachedBytes = 0;
+}
+
+void Workspace::resetStats() {
+    stats_.reused = 0;
+    stats_.heapAllocations = 0;
+}
+
+WorkspaceScope::WorkspaceScope(Workspace& workspace) : previous_(activeWorkspace) {
+    activeWorkspace = &workspace;
+}
+
+WorkspaceScope::~WorkspaceScope() {
+    activeWorkspace = previous_;
+}
+
+} // namespace utils
+} // namespace ml
\ No newline at end of file